@@ -4,19 +4,45 @@
 #include <QUrl>
 #include <QWidget>
 
+class LiquidSettings;
+class QLocalServer;
+
 class Liquid
 {
 public:
-    static void applyQtStyleSheets(QWidget* widget);
+    static bool appendLogRecord(const QString logFileName, const QStringList columnNames, const QStringList values);
+    static void applyChromiumFlags(const QString liquidAppName = QString());
+    static void applyQtStyleSheets(void);
     static void createDesktopFile(const QString liquidAppName, const QString liquidAppStartingUrl);
-    static bool detectDarkMode(void);
     static QByteArray generateRandomByteArray(const int byteLength);
     static QDir getAppsDir(void);
+    static QStringList getChromiumFlags(const QString liquidAppName = QString());
     static QDir getConfigDir(void);
+    static QDir getCookiesDir(void);
     static QString getDefaultUserAgentString(void);
+    static QDir getIconsDir(void);
+    static QFileInfoList getLiquidAppsFileList(void);
     static QStringList getLiquidAppsList(void);
+    static QList<qint64> getLiquidProcessIds(void);
+    static QDir getLogsDir(void);
+    static qint64 getProcessCpuTime(const qint64 pid);
+    static qint64 getProcessMemoryUsage(const qint64 pid);
+    static qint64 getProcessResidentSetSize(const qint64 pid);
+    static QList<QByteArray> getProcessStatFields(const qint64 pid);
+    static qint64 getProcessStatusValue(const qint64 pid, const QString fileName, const QByteArray key);
+    static QList<qint64> getProcessTreeIds(const qint64 pid);
+    static qint64 getProcessTreeMemoryUsage(const qint64 pid);
     static QString getReadableDateTimeString(void);
+    static QString getReadableMemoryUsage(const qint64 bytes);
+    static QDir getRuntimeDir(void);
+    static QDir getSnapshotsDir(void);
+    static QString getUserName(void);
+    static QString getUserStyleSheetFilePath(void);
+    static bool isLowMemoryModeEnabled(const LiquidSettings* liquidAppConfig);
+    static bool listenOnLocalSocket(QLocalServer* server, const QString serverName, bool* isInUse);
+    static qint64 measureLiquidAppMemoryUsage(const QString liquidAppName, const bool lowMemoryMode);
     static void removeDesktopFile(const QString liquidAppName);
     static void runLiquidApp(const QString liquidAppName);
+    static bool shredFile(const QString filePath);
     static void sleep(const int ms);
 };
@@ -76,4 +76,10 @@ private:
     QCheckBox* proxyUseAuthCheckBox;
     QLineEdit* proxyUsernameInput;
     QLineEdit* proxyPasswordInput;
+    QCheckBox* lowMemoryModeCheckBox;
+
+    // Performance tab
+    QSpinBox* freezeDelayInput;
+    QSpinBox* discardDelayInput;
+    QCheckBox* showSplashCheckBox;
 };
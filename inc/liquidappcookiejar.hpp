@@ -1,11 +1,14 @@
 #pragma once
 
+#include <QFileSystemWatcher>
+#include <QHash>
 #include <QNetworkCookie>
 #include <QNetworkCookieJar>
-#include <QSettings>
 #include <QWebEngineCookieStore>
 
+#include "liquidappcookiestore.hpp"
 #include "liquidappwindow.hpp"
+#include "liquidsettings.hpp"
 
 class LiquidAppCookieJar : public QNetworkCookieJar
 {
@@ -18,11 +21,44 @@ public:
     bool removeCookie(const QNetworkCookie& cookie);
     bool upsertCookie(const QNetworkCookie& cookie);
 
-    void restoreCookies(QWebEngineCookieStore* cookieStore);
+    // Cookies are kept in the hash below, not within the base class
+    QList<QNetworkCookie> cookiesForUrl(const QUrl& url) const override;
+    bool deleteCookie(const QNetworkCookie& cookie) override;
+    bool insertCookie(const QNetworkCookie& cookie) override;
+    bool updateCookie(const QNetworkCookie& cookie) override;
+
+    void restoreCookies(QWebEngineCookieStore* cookieStore, const QUrl startingUrl);
+
+signals:
+    void startingUrlCookiesRestored(void);
+
+protected:
+    QList<QNetworkCookie> allCookies(void) const;
+
+private slots:
+    void evictCookies(const QList<QNetworkCookie> evictedCookies);
+    void refreshPolicy(void);
+    void reloadConfig(void);
+    void restoreCookiesBatch(void);
 
 private:
-    QSettings* liquidAppConfig;
+    LiquidSettings* liquidAppConfig;
+    QFileSystemWatcher* liquidAppConfigWatcher;
+    LiquidAppCookieStore* liquidAppCookieStore;
     LiquidAppWindow* liquidAppWindow;
+    QWebEngineCookieStore* webEngineCookieStore = Q_NULLPTR;
+
+    void restoreCookie(QNetworkCookie cookie);
+
+    static QUrl getCookieOriginUrl(const QNetworkCookie& cookie);
+
+    // Cookies that are yet to be handed over to the web engine
+    QList<QNetworkCookie> cookiesToRestore;
+
+    // Cookie ID (domain, path, name) -> cookie
+    QHash<QByteArray, QNetworkCookie> cookies;
 
-    void save(void);
+    // Cached copies of the app's cookie policy
+    bool allowCookies = false;
+    bool allowThirdPartyCookies = false;
 };
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFuture>
+#include <QHash>
+#include <QNetworkCookie>
+#include <QObject>
+#include <QTimer>
+
+#include "liquidsettings.hpp"
+
+class LiquidAppCookieStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    // What the snapshot and the journal replay into
+    struct Contents {
+        // Cookie ID -> cookie
+        QHash<QByteArray, QNetworkCookie> cookies;
+        // Cookie ID -> when it was last set (ms since epoch), used to pick what to evict first
+        QHash<QByteArray, qint64> updateTimes;
+        int journalRecordCount = 0;
+        bool isJournalTorn = false;
+    };
+
+    LiquidAppCookieStore(const QString liquidAppName, QObject* parent = Q_NULLPTR);
+    ~LiquidAppCookieStore(void);
+
+    QList<QNetworkCookie> load(const Contents& contents, LiquidSettings* liquidAppConfig);
+    QFuture<Contents> read(void);
+    void removeCookie(const QNetworkCookie& cookie);
+    void upsertCookie(const QNetworkCookie& cookie);
+
+    static QByteArray getCookieId(const QNetworkCookie& cookie);
+    static QString getJournalFilePath(const QString liquidAppName);
+    static QString getSnapshotFilePath(const QString liquidAppName);
+    static QList<QNetworkCookie> readCookies(const QString liquidAppName, LiquidSettings* liquidAppConfig);
+
+signals:
+    void cookiesEvicted(const QList<QNetworkCookie> cookies);
+
+public slots:
+    void collectGarbage(void);
+    void flush(void);
+
+private:
+    void appendRecord(const QByteArray& record);
+    bool compact(qint64* reclaimedBytes = Q_NULLPTR);
+    QList<QNetworkCookie> evictLeastRecentlySet(QList<QByteArray> cookieIds, const int count);
+    qint64 getDiskUsage(void);
+    bool importFromConfig(LiquidSettings* liquidAppConfig);
+    bool isCompactionDue(void);
+    QList<QNetworkCookie> purge(int* expiredCount);
+
+    static QByteArray composeRecord(const char op, const QByteArray& cookieId, const QByteArray& rawCookie = QByteArray(), const qint64 updateTime = 0);
+    static QString getRegistrableDomain(QString domain);
+    static QNetworkCookie readCookie(QDataStream& in);
+    static Contents readFromDisk(const QString snapshotFilePath, const QString journalFilePath);
+    static void readJournal(const QString filePath, Contents& contents);
+    static void readLegacyCookies(LiquidSettings* liquidAppConfig, Contents& contents);
+    static bool readSnapshot(const QString filePath, Contents& contents);
+    static void writeCookie(QDataStream& out, const QNetworkCookie& cookie);
+
+    QString liquidAppName;
+    QString journalFilePath;
+    QString snapshotFilePath;
+    QTimer* flushTimer;
+    QTimer* garbageCollectionTimer;
+
+    Contents contents;
+    // Records not yet written to disk
+    QByteArray pendingRecords;
+};
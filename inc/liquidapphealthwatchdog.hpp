@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+#include <QWebEnginePage>
+
+class LiquidAppWebPage;
+
+class LiquidAppHealthWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidAppHealthWatchdog(const QString liquidAppName, LiquidAppWebPage* page, QObject* parent = Q_NULLPTR);
+
+signals:
+    void crashed(void);
+    void hung(void);
+
+private slots:
+    void onNavigation(void);
+    void onRenderProcessTerminated(const QWebEnginePage::RenderProcessTerminationStatus terminationStatus, const int exitCode);
+    void recover(void);
+    void sendHeartbeat(void);
+
+private:
+    bool isPaused(void) const;
+    void log(const QString event);
+
+    QString liquidAppName;
+    LiquidAppWebPage* page;
+
+    QTimer* heartbeatTimer;
+    QElapsedTimer heartbeatElapsedTimer;
+    quint64 heartbeatId = 0;
+    bool heartbeatIsPending = false;
+    int missedHeartbeatCount = 0;
+
+    // URL to load once the renderer is back
+    QUrl lastUrl;
+    bool rendererIsBeingKilled = false;
+
+    // Renderers that keep on crashing get brought back less and less eagerly
+    QElapsedTimer lastRecoveryElapsedTimer;
+    int recoveryDelay = 0;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QUrl>
+
+#include "liquidappwindow.hpp"
+#include "liquidinstanceserver.hpp"
+
+class LiquidAppHost : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidAppHost(QObject* parent = Q_NULLPTR);
+    ~LiquidAppHost(void);
+
+    bool launch(const QString liquidAppName, const QUrl url = QUrl());
+    bool listen(void);
+
+    static QString getServerName(void);
+    static bool requestLaunch(const QString liquidAppName, const QUrl url = QUrl());
+    static bool requestStats(qint64* hostProcessId, int* liquidAppCount);
+
+private slots:
+    void onNewConnection(void);
+
+private:
+    void handleRequest(QLocalSocket* socket, const QByteArray& request);
+
+    static QByteArray sendRequest(const QByteArray& request);
+
+    QLocalServer* server;
+
+    // Liquid app name -> window
+    QHash<QString, LiquidAppWindow*> liquidAppWindows;
+    // Liquid app name -> server that keeps it from being run by another process at the same time
+    QHash<QString, LiquidInstanceServer*> instanceServers;
+    // Liquid app name -> URLs asked to be opened while its window was still being set up
+    QHash<QString, QList<QUrl>> pendingUrls;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QIcon>
+#include <QPixmap>
+#include <QString>
+
+class LiquidAppIconCache
+{
+public:
+    static QIcon getIcon(const QString iconReference);
+    static QString getIconFilePath(const QString iconHash, const int size);
+    static bool isDataUrl(const QString iconReference);
+    static void removeIcon(const QString iconHash);
+    static void removeIconUnlessInUse(const QString iconHash, const QString exceptLiquidAppName = QString());
+    static QString storeDataUrl(const QString dataUrl);
+    static QString storeIcon(const QIcon& icon);
+    static QString storePixmap(const QPixmap& pixmap);
+};
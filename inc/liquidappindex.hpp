@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class LiquidAppIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    // What the launcher needs to know about a Liquid app without parsing its config file
+    struct Entry {
+        QString name;
+        QString title;
+        QString url;
+        QString icon;
+        // Used to tell if the config file has changed since it was indexed
+        qint64 modificationTime = 0;
+        qint64 size = 0;
+    };
+
+    LiquidAppIndex(QObject* parent = Q_NULLPTR);
+
+    QList<Entry> getEntries(void);
+    void refresh(void);
+
+    static QString getIndexFilePath(void);
+
+private:
+    bool readFromDisk(void);
+    bool writeToDisk(void);
+
+    static Entry readEntry(const QFileInfo& liquidAppConfigFileInfo);
+    static Entry readEntry(QDataStream& in);
+    static void writeEntry(QDataStream& out, const Entry& entry);
+
+    QString indexFilePath;
+
+    // Liquid app names in the order they get listed
+    QStringList liquidAppNames;
+    // Liquid app name -> entry
+    QHash<QString, Entry> entries;
+};
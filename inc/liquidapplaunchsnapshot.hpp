@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+
+class LiquidAppLaunchSnapshot
+{
+public:
+    // Everything Liquid app's settings file has in it
+    QHash<QString, QVariant> values;
+    // Ready to be injected into web page
+    QString additionalCssScriptSource;
+    QString additionalJsScriptSource;
+
+    // Settings file this got made out of
+    QDateTime settingsFileModificationTime;
+    qint64 settingsFileSize = -1;
+
+    // Whether settings file had to be parsed, and how long it took to get all of the above (microseconds)
+    bool isFromSettingsFile = false;
+    qint64 loadTime = -1;
+
+    static QString getAdditionalCssScriptSource(QString additionalCss);
+    static QString getFilePath(const QString liquidAppName);
+    static LiquidAppLaunchSnapshot load(const QString liquidAppName);
+    static bool store(const QString liquidAppName);
+
+private:
+    static LiquidAppLaunchSnapshot build(const QString liquidAppName);
+    static bool read(const QString filePath, LiquidAppLaunchSnapshot& snapshot);
+    static bool write(const QString filePath, const LiquidAppLaunchSnapshot& snapshot);
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QObject>
+#include <QPointF>
+#include <QTimer>
+#include <QWebEnginePage>
+
+class LiquidAppLifecycle : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidAppLifecycle(QWebEnginePage* page, const int freezeDelay, const int discardDelay, QObject* parent = Q_NULLPTR);
+
+    void discard(void);
+
+private slots:
+    void onLoadFinished(const bool ok);
+    void onVisibleChanged(const bool visible);
+    void update(void);
+
+private:
+    QWebEnginePage* page;
+
+    QTimer* freezeTimer;
+    QTimer* discardTimer;
+    bool freezeIsDue = false;
+    bool discardIsDue = false;
+
+    // Where the page was scrolled to before it got discarded
+    QPointF scrollPosition;
+    bool scrollPositionIsPendingRestore = false;
+};
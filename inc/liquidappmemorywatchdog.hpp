@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QDateTime>
+#include <QObject>
+#include <QTimer>
+#include <QWebEnginePage>
+
+class LiquidAppMemoryWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidAppMemoryWatchdog(const QString liquidAppName, QWebEnginePage* page, const qint64 softLimit, const qint64 hardLimit, QObject* parent = Q_NULLPTR);
+
+    bool isOverSoftLimit(void);
+
+signals:
+    void hardLimitExceeded(void);
+    void softLimitExceededChanged(const bool isOverSoftLimit);
+
+private slots:
+    void check(void);
+
+private:
+    void log(const qint64 renderProcessId, const qint64 memoryUsage, const QString event);
+
+    QString liquidAppName;
+    QWebEnginePage* page;
+    QTimer* checkTimer;
+
+    // Bytes, zero (or less) means no limit
+    qint64 softLimit;
+    qint64 hardLimit;
+
+    bool overSoftLimit = false;
+    // Reloading a page that's simply big may get it right back over the limit
+    QDateTime lastHardLimitActionTime;
+};
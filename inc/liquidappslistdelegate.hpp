@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QPersistentModelIndex>
+#include <QStyledItemDelegate>
+
+class LiquidAppsListDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    enum Action {
+        NoAction = -1,
+        DeleteAction,
+        EditAction,
+        RunAction,
+        ActionCount
+    };
+
+    LiquidAppsListDelegate(QObject* parent = Q_NULLPTR);
+
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index) override;
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+signals:
+    void actionTriggered(const Action action, const QModelIndex& index);
+
+private:
+    static Action getActionAt(const QRect& rect, const QPoint& pos);
+    static QRect getActionRect(const QRect& rect, const Action action);
+    void setHoveredAction(const QWidget* view, const QModelIndex& index, const Action action);
+
+    // Action button the mouse cursor is currently over
+    QPersistentModelIndex hoveredIndex;
+    Action hoveredAction = NoAction;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QIcon>
+
+#include "liquidappindex.hpp"
+#include "liquidinstanceregistry.hpp"
+
+class LiquidAppsListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        StatusColumn,
+        ActionsColumn,
+        ColumnCount
+    };
+
+    LiquidAppsListModel(QObject* parent = Q_NULLPTR);
+
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+    QString getLiquidAppName(const QModelIndex& index) const;
+    void setEntries(const QList<LiquidAppIndex::Entry> entries);
+    void setInstanceRecords(const QList<LiquidInstanceRegistry::Record> records);
+
+private:
+    QIcon getIcon(const LiquidAppIndex::Entry& entry) const;
+
+    QList<LiquidAppIndex::Entry> entries;
+
+    // Liquid app name -> icon, loaded only once its row gets painted
+    mutable QHash<QString, QIcon> icons;
+
+    // Liquid app name -> resource usage, only for ones that are running
+    QHash<QString, LiquidInstanceRegistry::Record> instanceRecords;
+};
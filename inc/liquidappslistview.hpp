@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QColor>
+#include <QTableView>
+
+#include "liquidappslistdelegate.hpp"
+
+class LiquidAppsListView : public QTableView
+{
+    Q_OBJECT
+
+    // Colors of action buttons the mouse cursor is over, meant to be set via stylesheets
+    Q_PROPERTY(QColor deleteActionHoverColor MEMBER deleteActionHoverColor)
+    Q_PROPERTY(QColor deleteActionHoverBackgroundColor MEMBER deleteActionHoverBackgroundColor)
+    Q_PROPERTY(QColor editActionHoverColor MEMBER editActionHoverColor)
+    Q_PROPERTY(QColor editActionHoverBackgroundColor MEMBER editActionHoverBackgroundColor)
+    Q_PROPERTY(QColor runActionHoverColor MEMBER runActionHoverColor)
+    Q_PROPERTY(QColor runActionHoverBackgroundColor MEMBER runActionHoverBackgroundColor)
+
+public:
+    LiquidAppsListView(QWidget* parent = Q_NULLPTR);
+
+    QColor getActionHoverBackgroundColor(const LiquidAppsListDelegate::Action action) const;
+    QColor getActionHoverColor(const LiquidAppsListDelegate::Action action) const;
+
+private:
+    QColor deleteActionHoverColor;
+    QColor deleteActionHoverBackgroundColor = Qt::transparent;
+    QColor editActionHoverColor;
+    QColor editActionHoverBackgroundColor = Qt::transparent;
+    QColor runActionHoverColor;
+    QColor runActionHoverBackgroundColor = Qt::transparent;
+};
@@ -17,6 +17,8 @@ public:
     void addAllowedDomain(const QString domain);
     void addAllowedDomains(const QStringList domainList);
     void closeJsDialog();
+    bool isDialogOpen(void) const;
+    bool isDomainAllowed(const QString domain);
 
     static void setWebSettingsToDefault(QWebEngineSettings* webSettings);
 
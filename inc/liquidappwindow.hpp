@@ -3,16 +3,25 @@
 #include <QAction>
 #include <QCloseEvent>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QLabel>
 #include <QMenu>
 #include <QNetworkProxy>
-#include <QSettings>
 #include <QShortcut>
+#include <QTimer>
 #include <QWebEngineView>
 #include <QWebEngineFullScreenRequest>
 
 #include "liquidappwebpage.hpp"
 
+class LiquidAppCookieJar;
+class LiquidAppHealthWatchdog;
+class LiquidAppLifecycle;
+class LiquidAppMemoryWatchdog;
 class LiquidAppWebPage;
+class LiquidInstanceRegistry;
+class LiquidSettings;
 
 class LiquidAppWindow : public QWebEngineView
 {
@@ -24,9 +33,12 @@ public:
 
     void setForgiveNextPageLoadError(const bool ok);
 
-    QSettings* liquidAppConfig;
+    static QString getSplashFilePath(const QString liquidAppName);
+
+    LiquidSettings* liquidAppConfig;
 
 public slots:
+    void activate(const QUrl url = QUrl());
     void certificateError(void);
     void exitFullScreenMode(void);
     void hardReload(void);
@@ -53,21 +65,55 @@ protected:
     void contextMenuEvent(QContextMenuEvent* event) override;
 
 private:
+    void hideSplash(void);
+    QImage renderToImage(const QSize size);
+    void saveSplash(void);
+    void showSplash(void);
     void takeSnapshot(const bool fullPage);
     const QString colorToRgba(const QColor color);
 
     QString* liquidAppName;
 
     QString liquidAppWindowTitle;
-    QIcon iconToSave;
-
+    QString iconHashToSave;
+    // Tells apart icons that have already been stored from new ones
+    qint64 iconCacheKey = 0;
+
+    // URL asked to be opened before the starting one got a chance to load
+    QUrl urlToOpen;
+    bool startingUrlIsLoaded = false;
+
+    LiquidAppCookieJar* liquidAppCookieJar = Q_NULLPTR;
+    LiquidAppHealthWatchdog* liquidAppHealthWatchdog = Q_NULLPTR;
+    LiquidAppLifecycle* liquidAppLifecycle = Q_NULLPTR;
+    LiquidAppMemoryWatchdog* liquidAppMemoryWatchdog = Q_NULLPTR;
+    LiquidInstanceRegistry* liquidAppInstanceRegistry = Q_NULLPTR;
     LiquidAppWebPage* liquidAppWebPage = Q_NULLPTR;
     QWebEngineProfile* liquidAppWebProfile = Q_NULLPTR;
     QWebEngineSettings* liquidAppWebSettings = Q_NULLPTR;
     QByteArray liquidAppWindowGeometry;
+    QTimer* windowGeometryTimer = Q_NULLPTR;
     QList<qreal> zoomFactors;
+    // Kept to be re-applied after navigation, since Qt may lose it
+    qreal zoomFactorInEffect = 1.0;
+
+    // Startup milestones, in microseconds since window's construction began (see LQD_LAUNCH_LOG_NAME)
+    QElapsedTimer launchElapsedTimer;
+    bool launchSettingsAreFromSnapshot = false;
+    qint64 launchSettingsLoadTime = -1;
+    qint64 launchConfigAppliedTime = -1;
+    qint64 launchNavigationStartedTime = -1;
+    qint64 launchWindowShownTime = -1;
+    qint64 launchUiReadyTime = -1;
+    bool launchIsLogged = false;
+
+    // Last rendered frame from the previous run, shown until the web page gets painted
+    QLabel* splash = Q_NULLPTR;
+    QTimer* splashTimer = Q_NULLPTR;
+    bool splashPaintCheckIsPending = false;
 
     bool liquidAppWindowTitleIsReadOnly = false;
+    bool lowMemoryMode = false;
     bool forgiveNextPageLoadError = false;
     bool pageHasCertificateError = false;
     bool pageHasError = false;
@@ -110,6 +156,8 @@ private:
 
     void bindKeyboardShortcuts(void);
     void loadLiquidAppConfig(void);
+    void logLaunch(const qint64 firstPaintTime);
     void saveLiquidAppConfig(void);
     void setupContextMenu(void);
+    void snapshotWindowGeometry(void);
 };
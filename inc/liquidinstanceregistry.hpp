@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QWebEnginePage>
+
+class LiquidInstanceRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Record {
+        QString liquidAppName;
+        qint64 processId = -1;
+        qint64 renderProcessId = -1;
+        QDateTime startTime;
+        // Liquid app's own process (resident set size, without web engine's GPU, utility, renderer processes),
+        // given in only one record per process (several Liquid apps may share one, see LiquidAppHost)
+        qint64 memoryUsage = -1;
+        qreal cpuUsage = -1;
+        // Only the renderer process of Liquid app's web page (resident set size)
+        qint64 renderProcessMemoryUsage = -1;
+        qreal renderProcessCpuUsage = -1;
+        // Last time the Liquid app's process got to update it
+        QDateTime updateTime;
+    };
+
+    LiquidInstanceRegistry(const QString liquidAppName, QWebEnginePage* page, QObject* parent = Q_NULLPTR);
+    ~LiquidInstanceRegistry(void);
+
+    static QList<Record> getRecords(void);
+    static QDir getRegistryDir(void);
+
+private:
+    static qreal getCpuUsage(const qint64 cpuTime, const qint64 lastCpuTime, const qint64 elapsed);
+    static void updateAll(void);
+
+    void update(void);
+
+    Record record;
+    QString recordFilePath;
+
+    QWebEnginePage* page;
+
+    // Used to turn CPU time spent between updates into usage
+    QElapsedTimer updateElapsedTimer;
+    qint64 lastRenderProcessCpuTime = -1;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QUrl>
+
+class LiquidInstanceServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidInstanceServer(const QString liquidAppName, QObject* parent = Q_NULLPTR);
+
+    bool listen(void);
+
+    static QString getServerName(const QString liquidAppName);
+    static bool requestActivation(const QString liquidAppName, const QUrl url = QUrl());
+
+signals:
+    void activationRequested(const QUrl url);
+
+private slots:
+    void onNewConnection(void);
+
+private:
+    QLocalServer* server;
+    QString serverName;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+
+class LiquidLauncherDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    LiquidLauncherDaemon(QObject* parent = Q_NULLPTR);
+    ~LiquidLauncherDaemon(void);
+
+    bool listen(void);
+
+    static QString getServerName(void);
+    static bool requestLaunch(const QString liquidAppName);
+    static QString waitForLaunchRequest(void);
+
+private slots:
+    void onNewConnection(void);
+    void spawnStandbyProcess(void);
+
+private:
+    void handleRequest(QLocalSocket* socket, const QByteArray& request);
+    void launch(const QString liquidAppName);
+
+    QLocalServer* server;
+
+    // Pre-initialized processes waiting to be told which Liquid app to become
+    QList<QLocalSocket*> standbySockets;
+    bool isStandbyProcessStarting = false;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+class LiquidRenderingBackend
+{
+public:
+    static void detect(void);
+    static void detectUnlessKnown(void);
+    static QStringList getDiagnostics(void);
+    static QString getGlRenderer(void);
+    static int getRasterThreadCount(const bool isGpuUsable);
+    static bool isGpuUsable(void);
+
+private:
+    static QString getEnvironment(void);
+    static QStringList getGpuDevices(void);
+    static QString getMachineGroupName(void);
+    static bool isSoftwareRenderer(const QString glRenderer);
+    static bool probeGpuDevices(void);
+    static QProcess* startProbe(QObject* parent = Q_NULLPTR);
+    static QString storeProbeResult(QProcess* probeProcess);
+};
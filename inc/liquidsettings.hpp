@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QSettings>
+#include <QStringList>
+#include <QTimer>
+#include <QVariant>
+
+class LiquidSettings : public QObject
+{
+    Q_OBJECT
+
+public:
+    static LiquidSettings* forLiquidApp(const QString liquidAppName);
+    static LiquidSettings* forProgram(void);
+    static void forgetLiquidApp(const QString liquidAppName);
+    static QString getLiquidAppFilePath(const QString liquidAppName);
+    static void waitForFlush(void);
+
+    QStringList allKeys(void) const;
+    void beginGroup(const QString prefix);
+    bool contains(const QString key) const;
+    void endGroup(void);
+    QString fileName(void) const;
+    void reload(void);
+    void remove(const QString key);
+    void setValue(const QString key, const QVariant value);
+    void sync(void);
+    QVariant value(const QString key, const QVariant defaultValue = QVariant()) const;
+
+signals:
+    // Values got replaced with what another process has written into the file
+    void reloaded(void);
+
+private slots:
+    void flush(void);
+
+private:
+    struct Contents {
+        QHash<QString, QVariant> values;
+        QDateTime modificationTime;
+    };
+
+    LiquidSettings(const QString fileName, const QSettings::Format format, const QString liquidAppName = QString());
+
+    QDateTime getFileModificationTime(void) const;
+    QString getFullKey(const QString key) const;
+    bool hasPendingChanges(void) const;
+    bool isModifiedElsewhere(void);
+    void parse(const QSettings& settings);
+
+    static Contents readFromDisk(const QString fileName, const QSettings::Format format);
+    static void removeKey(QHash<QString, QVariant>& keyValues, const QString fullKey);
+    static void writeToDisk(const QString fileName, const QSettings::Format format, const QString liquidAppName, const QSet<QString> removedKeys, const QHash<QString, QVariant> changedValues);
+
+    // Empty for program's own settings
+    QString liquidAppName;
+    QString settingsFileName;
+    QSettings::Format settingsFormat;
+
+    // Everything the file contained, along with changes made since
+    QHash<QString, QVariant> values;
+    QDateTime parsedFileModificationTime;
+    QStringList groups;
+
+    // Changes yet to be handed over for writing
+    QSet<QString> removedKeys;
+    QHash<QString, QVariant> changedValues;
+    QTimer* flushTimer;
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QProcess>
+
+#if defined(Q_OS_LINUX)
+#include <QDBusVariant>
+#endif
+
+class LiquidThemeService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static LiquidThemeService* instance(void);
+    static bool getLastKnownDarkMode(void);
+
+    bool isDarkMode(void);
+
+signals:
+    void darkModeChanged(const bool isDarkMode);
+
+private slots:
+#if defined(Q_OS_LINUX)
+    void onPortalSettingChanged(const QString nameSpace, const QString key, const QDBusVariant value);
+    void onQueryProcessFinished(void);
+#endif
+    void onUserStyleSheetChanged(void);
+    void refresh(void);
+
+private:
+    LiquidThemeService(QObject* parent = Q_NULLPTR);
+    ~LiquidThemeService(void);
+
+#if defined(Q_OS_LINUX)
+    void queryGsettings(void);
+    void queryPortal(void);
+    void setColorScheme(const uint colorScheme);
+#endif
+    void setDarkMode(const bool isDarkMode);
+
+    static bool detectDarkModeFromPalette(void);
+    static bool detectSystemDarkMode(void);
+    static bool isDarkThemeName(QString themeName);
+
+    bool darkMode = false;
+
+    // Child process used to ask gsettings for the desktop's theme, only when there's no portal
+    QProcess* queryProcess = Q_NULLPTR;
+
+    // Used to rebuild the program's stylesheet whenever the user-defined one gets modified
+    QFileSystemWatcher* userStyleSheetWatcher;
+    QDateTime userStyleSheetModificationTime;
+    qint64 userStyleSheetSize = -1;
+};
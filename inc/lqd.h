@@ -3,6 +3,13 @@
 /* Various globals */
 #define LQD_PROG_TITLE         "Liquid"
 #define LQD_APPS_DIR_NAME      "apps"
+#define LQD_APPS_INDEX_NAME    "apps.index"
+#define LQD_COOKIES_DIR_NAME   "cookies"
+#define LQD_ICONS_DIR_NAME     "icons"
+#define LQD_INSTANCES_DIR_NAME "instances"
+#define LQD_LOGS_DIR_NAME      "logs"
+#define LQD_RUNTIME_DIR_NAME   "runtime" // within config directory, when the temporary one can't be used
+#define LQD_SNAPSHOTS_DIR_NAME "snapshots"
 #define LQD_DEFAULT_BG_COLOR   Qt::white
 #define LQD_DEFAULT_PROXY_HOST "0.0.0.0"
 #define LQD_DEFAULT_PROXY_PORT 8080
@@ -11,10 +18,82 @@
 #define LQD_APP_WIN_MIN_SIZE_W 160
 #define LQD_APP_WIN_MIN_SIZE_H 120
 #define LQD_UI_MARGIN          24
+#define LQD_APP_LIST_BTN_W     40
+#define LQD_APP_LIST_DEBOUNCE  100 // ms
+#define LQD_WIN_GEOM_DEBOUNCE  200 // ms
 #define LQD_ZOOM_LVL_MIN       0.25
 #define LQD_ZOOM_LVL_MAX       5.0 // Limited to 5.0 by Chromium
 #define LQD_ZOOM_LVL_STEP      0.04
 #define LQD_ZOOM_LVL_STEP_FINE (LQD_ZOOM_LVL_STEP / 10)
+#define LQD_ENV_VAR_THEME      "LIQUID_THEME" // "dark" or "light", overrides system theme detection
+#define LQD_ENV_VAR_CHROMIUM   "LIQUID_USER_CHROMIUM_FLAGS" // internal, QTWEBENGINE_CHROMIUM_FLAGS as set by the user
+#define LQD_ENV_VAR_RENDERING  "LIQUID_RENDERING" // "gpu" or "software", overrides rendering backend detection
+#define LQD_ENV_VAR_LOW_MEMORY "LIQUID_LOW_MEMORY_MODE" // "1" or "0", overrides Liquid app's low-memory mode setting
+
+/* Cookie journal */
+#define LQD_COOKIES_JOURNAL_FLUSH_DELAY          500 // ms
+#define LQD_COOKIES_JOURNAL_COMPACTION_THRESHOLD 256 // records
+#define LQD_COOKIES_RESTORE_BATCH_SIZE           64 // cookies per event loop iteration
+#define LQD_COOKIES_GC_INTERVAL                  (60 * 60 * 1000) // ms
+/* Cookie limits (same as Chromium's) */
+#define LQD_COOKIES_MAX_PER_DOMAIN               180
+#define LQD_COOKIES_PURGE_PER_DOMAIN             30 // evicted at once when over the limit
+#define LQD_COOKIES_MAX_TOTAL                    3300
+#define LQD_COOKIES_PURGE_TOTAL                  300 // evicted at once when over the limit
+
+/* Rendering backend detection */
+#define LQD_RENDERING_PROBE_FLAG    "--probe-rendering" // internal, makes the process print its OpenGL renderer and quit
+#define LQD_RENDERING_PROBE_TIMEOUT 10000 // ms
+
+/* Launcher daemon */
+#define LQD_LAUNCHER_CONNECT_TIMEOUT 100 // ms
+#define LQD_LAUNCHER_REPLY_TIMEOUT   1000 // ms
+#define LQD_LAUNCHER_RESPAWN_DELAY   1000 // ms
+#define LQD_LAUNCHER_STANDBY_TIMEOUT 30000 // ms
+
+/* Launch snapshot */
+#define LQD_LAUNCH_LOG_NAME "launch-stages.csv" // launch.csv had fewer columns
+
+/* Splash */
+#define LQD_SPLASH_SCALE         0.5
+#define LQD_SPLASH_POLL_INTERVAL 50 // ms
+#define LQD_SPLASH_FADE_DURATION 250 // ms
+
+/* Settings */
+#define LQD_SETTINGS_FLUSH_DELAY 500 // ms
+
+/* Instance registry */
+#define LQD_INSTANCE_STATS_INTERVAL 5000 // ms
+
+/* Background lifecycle (defaults) */
+#define LQD_LIFECYCLE_FREEZE_DELAY  0 // s, never unless set for the Liquid app
+#define LQD_LIFECYCLE_DISCARD_DELAY 0 // s, never unless set for the Liquid app
+
+/* Memory watchdog */
+#define LQD_WATCHDOG_MEMORY_INTERVAL 5000 // ms
+#define LQD_WATCHDOG_MEMORY_COOLDOWN 60000 // ms, least time between two reloads
+#define LQD_WATCHDOG_MEMORY_LOG_NAME "memory-watchdog.csv"
+
+/* Health watchdog */
+#define LQD_WATCHDOG_HEALTH_INTERVAL   2500 // ms, between heartbeats
+#define LQD_WATCHDOG_HEALTH_TIMEOUT    5000 // ms, heartbeat that takes longer than that to get answered counts as missed
+#define LQD_WATCHDOG_HEALTH_MAX_MISSED 2 // heartbeats missed in a row before the renderer is considered hung
+#define LQD_WATCHDOG_HEALTH_MAX_DELAY  30000 // ms, longest wait before bringing back a renderer that keeps crashing
+#define LQD_WATCHDOG_HEALTH_LOG_NAME   "health-watchdog.csv"
+
+/* Engine settings, values beyond these get clamped */
+#define LQD_ENGINE_JS_HEAP_LIMIT_MIN   16 // MiB
+#define LQD_ENGINE_JS_HEAP_LIMIT_MAX   (16 * 1024) // MiB
+#define LQD_ENGINE_RASTER_THREADS_MAX  16
+#define LQD_ENGINE_RENDERER_LIMIT_MAX  64
+
+/* Low-memory mode */
+#define LQD_LOW_MEMORY_JS_HEAP_LIMIT      128 // MiB
+#define LQD_LOW_MEMORY_HTTP_CACHE_SIZE    (4 * 1024 * 1024) // bytes
+#define LQD_LOW_MEMORY_HISTORY_LIMIT      20 // back/forward history entries, cleared once there are twice as many
+#define LQD_MEMORY_REPORT_SETTLE_TIME     20000 // ms
+#define LQD_MEMORY_REPORT_SAMPLE_COUNT    5
+#define LQD_MEMORY_REPORT_SAMPLE_INTERVAL 1000 // ms
 
 /* Textual icons */
 #define LQD_ICON_ADD     "➕"
@@ -27,9 +106,22 @@
 #define LQD_ICON_DELETE  "✖"
 #define LQD_ICON_RUN     "➤"
 
+/* Program config group names */
+#define LQD_CFG_GROUP_NAME_RENDERING             "Rendering" // contains one group per machine
+
+/* Program config key names */
+#define LQD_CFG_KEY_NAME_DARK_MODE               "DarkMode" // boolean, last detected system theme
+#define LQD_CFG_KEY_NAME_RENDERING_DETECTED_AT   "DetectedAt" // date and time, within machine's rendering group
+#define LQD_CFG_KEY_NAME_RENDERING_ENVIRONMENT   "Environment" // text, Qt and kernel versions and GPU devices detected with, within machine's rendering group
+#define LQD_CFG_KEY_NAME_RENDERING_GL_RENDERER   "GLRenderer" // text, within machine's rendering group
+#define LQD_CFG_KEY_NAME_RENDERING_USE_GPU       "UseGPU" // boolean, within machine's rendering group
+
 /* Liquid App config file group names */
 #define LQD_CFG_GROUP_NAME_COOKIES               "Cookies"
+#define LQD_CFG_GROUP_NAME_ENGINE                "Engine"
+#define LQD_CFG_GROUP_NAME_LIFECYCLE             "Lifecycle"
 #define LQD_CFG_GROUP_NAME_PROXY                 "Proxy"
+#define LQD_CFG_GROUP_NAME_WATCHDOG              "Watchdog"
 
 /*
  * Liquid App config key names.
@@ -45,9 +137,17 @@
 #define LQD_CFG_KEY_NAME_ALLOW_3RD_PARTY_COOKIES "AllowThirdPartyCookies" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_CUSTOM_BG_COLOR         "CustomBackgroundColor" // text
 #define LQD_CFG_KEY_NAME_ENABLE_JS               "EnableJS" // boolean, defaults to FALSE
+#define LQD_CFG_KEY_NAME_ENGINE_ADDITIONAL_FLAGS LQD_CFG_GROUP_NAME_ENGINE "/" "AdditionalFlags" // text, whitespace-separated Chromium flags
+#define LQD_CFG_KEY_NAME_ENGINE_DISABLE_GPU      LQD_CFG_GROUP_NAME_ENGINE "/" "DisableGPU" // boolean, defaults to FALSE
+#define LQD_CFG_KEY_NAME_ENGINE_JS_HEAP_LIMIT    LQD_CFG_GROUP_NAME_ENGINE "/" "JSHeapLimit" // number, MiB
+#define LQD_CFG_KEY_NAME_ENGINE_RASTER_THREADS   LQD_CFG_GROUP_NAME_ENGINE "/" "RasterThreads" // number, clamped to 1-16, defaults to 1-4 depending on CPU cores and GPU, 1 in low-memory mode
+#define LQD_CFG_KEY_NAME_ENGINE_RENDERER_LIMIT   LQD_CFG_GROUP_NAME_ENGINE "/" "RendererProcessLimit" // number
 #define LQD_CFG_KEY_NAME_HIDE_SCROLLBARS         "HideScrollBars" // boolean, defaults to FALSE
-#define LQD_CFG_KEY_NAME_ICON                    "Icon" // text
+#define LQD_CFG_KEY_NAME_ICON                    "Icon" // text, hash of the icon within the icon cache
+#define LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY LQD_CFG_GROUP_NAME_LIFECYCLE "/" "DiscardDelay" // number, seconds of being hidden, 0 means never
+#define LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY  LQD_CFG_GROUP_NAME_LIFECYCLE "/" "FreezeDelay" // number, seconds of being hidden, 0 means never
 #define LQD_CFG_KEY_NAME_LOCK_WIN_GEOM           "LockWindowGeometry" // boolean, defaults to FALSE
+#define LQD_CFG_KEY_NAME_LOW_MEMORY_MODE         "LowMemoryMode" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_MUTE_AUDIO              "MuteAudio" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_NOTES                   "Notes" // text
 #define LQD_CFG_KEY_NAME_PROXY_HOST              LQD_CFG_GROUP_NAME_PROXY "/" "Host" // text
@@ -57,11 +157,16 @@
 #define LQD_CFG_KEY_NAME_PROXY_USER_NAME         LQD_CFG_GROUP_NAME_PROXY "/" "UserName" // text
 #define LQD_CFG_KEY_NAME_PROXY_USER_PASSWORD     LQD_CFG_GROUP_NAME_PROXY "/" "UserPassword" // text
 #define LQD_CFG_KEY_NAME_REMOVE_WINDOW_FRAME     "RemoveWindowFrame" // boolean, defaults to FALSE
+#define LQD_CFG_KEY_NAME_SHOW_SPLASH             "ShowSplash" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_TITLE                   "Title" // text
 #define LQD_CFG_KEY_NAME_USE_PROXY               "UseProxy" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_USE_CUSTOM_BG           "UseCustomBackground" // boolean, defaults to FALSE
 #define LQD_CFG_KEY_NAME_USER_AGENT              "UserAgent" // text
 #define LQD_CFG_KEY_NAME_URL                     "URL" // text, required
+#define LQD_CFG_KEY_NAME_WATCHDOG_CRASH_COUNT    LQD_CFG_GROUP_NAME_WATCHDOG "/" "CrashCount" // number, times renderer crashed
+#define LQD_CFG_KEY_NAME_WATCHDOG_HANG_COUNT     LQD_CFG_GROUP_NAME_WATCHDOG "/" "HangCount" // number, times renderer hung
+#define LQD_CFG_KEY_NAME_WATCHDOG_HARD_LIMIT     LQD_CFG_GROUP_NAME_WATCHDOG "/" "HardMemoryLimit" // number, renderer's memory in MiB
+#define LQD_CFG_KEY_NAME_WATCHDOG_SOFT_LIMIT     LQD_CFG_GROUP_NAME_WATCHDOG "/" "SoftMemoryLimit" // number, renderer's memory in MiB
 #define LQD_CFG_KEY_NAME_WIN_GEOM                "WindowGeometry" // text
 #define LQD_CFG_KEY_NAME_ZOOM_LVL                "ZoomLevel" // number, defaults to 1
 
@@ -1,10 +1,16 @@
 #pragma once
 
 #include <QAction>
+#include <QFileSystemWatcher>
 #include <QPushButton>
-#include <QSettings>
 #include <QScrollArea>
-#include <QTableWidget>
+#include <QTimer>
+
+#include "liquidappindex.hpp"
+#include "liquidappslistdelegate.hpp"
+#include "liquidappslistmodel.hpp"
+#include "liquidappslistview.hpp"
+#include "liquidsettings.hpp"
 
 class MainWindow : public QScrollArea
 {
@@ -17,14 +23,21 @@ protected:
 
 private:
     void bindShortcuts(void);
-    void flushTable(void);
+    void deleteLiquidApp(const QString liquidAppName);
+    void editLiquidApp(const QString liquidAppName);
     void populateTable(void);
     void runLiquidApp(const QString liquidAppName);
     void saveSettings(void);
 
-    QTableWidget* appListTable;
+    LiquidAppsListDelegate* appListDelegate;
+    LiquidAppsListModel* appListModel;
+    LiquidAppsListView* appListView;
+    QTimer* appsDirRefreshTimer;
+    QFileSystemWatcher* appsDirWatcher;
     QPushButton* createNewLiquidAppButton;
-    QSettings* settings;
+    QTimer* instanceRecordsRefreshTimer;
+    LiquidAppIndex* liquidAppIndex;
+    LiquidSettings* settings;
 
     QAction* quitAction;
 };
@@ -4,7 +4,9 @@ VERSION_PATCH = 11
 
 VERSION      = $${VERSION_MAJOR}.$${VERSION_MINOR}.$${VERSION_PATCH}
 
-QT          += core gui webenginewidgets
+QT          += core gui concurrent network webenginewidgets
+# Desktop theme changes (see LiquidThemeService)
+linux: QT += dbus
 CONFIG      += c++11
 TEMPLATE     = app
 
@@ -25,16 +27,50 @@ INCLUDEPATH += $${INC_DIR}
 HEADERS     += inc/lqd.h \
                inc/liquid.hpp \
                inc/liquidappcookiejar.hpp \
+               inc/liquidappcookiestore.hpp \
                inc/liquidappconfigwindow.hpp \
+               inc/liquidapphealthwatchdog.hpp \
+               inc/liquidapphost.hpp \
+               inc/liquidappiconcache.hpp \
+               inc/liquidappindex.hpp \
+               inc/liquidapplaunchsnapshot.hpp \
+               inc/liquidapplifecycle.hpp \
+               inc/liquidappmemorywatchdog.hpp \
+               inc/liquidappslistdelegate.hpp \
+               inc/liquidappslistmodel.hpp \
+               inc/liquidappslistview.hpp \
                inc/liquidappwebpage.hpp \
                inc/liquidappwindow.hpp \
+               inc/liquidinstanceregistry.hpp \
+               inc/liquidinstanceserver.hpp \
+               inc/liquidlauncherdaemon.hpp \
+               inc/liquidrenderingbackend.hpp \
+               inc/liquidsettings.hpp \
+               inc/liquidthemeservice.hpp \
                inc/mainwindow.hpp \
 
 SOURCES     += src/liquid.cpp \
                src/liquidappcookiejar.cpp \
+               src/liquidappcookiestore.cpp \
                src/liquidappconfigwindow.cpp \
+               src/liquidapphealthwatchdog.cpp \
+               src/liquidapphost.cpp \
+               src/liquidappiconcache.cpp \
+               src/liquidappindex.cpp \
+               src/liquidapplaunchsnapshot.cpp \
+               src/liquidapplifecycle.cpp \
+               src/liquidappmemorywatchdog.cpp \
+               src/liquidappslistdelegate.cpp \
+               src/liquidappslistmodel.cpp \
+               src/liquidappslistview.cpp \
                src/liquidappwebpage.cpp \
                src/liquidappwindow.cpp \
+               src/liquidinstanceregistry.cpp \
+               src/liquidinstanceserver.cpp \
+               src/liquidlauncherdaemon.cpp \
+               src/liquidrenderingbackend.cpp \
+               src/liquidsettings.cpp \
+               src/liquidthemeservice.cpp \
                src/main.cpp \
                src/mainwindow.cpp \
 
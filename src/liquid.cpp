@@ -1,21 +1,65 @@
 #include "lqd.h"
 #include "liquid.hpp"
+#include "liquidapphost.hpp"
+#include "liquidinstanceserver.hpp"
+#include "liquidlauncherdaemon.hpp"
+#include "liquidrenderingbackend.hpp"
+#include "liquidsettings.hpp"
+#include "liquidthemeservice.hpp"
 
 #include <QApplication>
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QLockFile>
+#include <QMap>
+#include <QMultiHash>
 #include <QProcess>
+#include <QProcessEnvironment>
 #include <QSettings>
+#include <QStandardPaths>
 #include <QTime>
 #include <QWebEngineProfile>
 
-#if defined(Q_OS_MAC)
-#include <CoreFoundation/CoreFoundation.h>
-#include <CoreServices/CoreServices.h>
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
 #endif
 
-void Liquid::applyQtStyleSheets(QWidget* widget)
+bool Liquid::appendLogRecord(const QString logFileName, const QStringList columnNames, const QStringList values)
+{
+    QDir().mkpath(getLogsDir().absolutePath());
+
+    QFile logFile(getLogsDir().absolutePath() + QDir::separator() + logFileName);
+    const bool isNew = !logFile.exists();
+
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qDebug().noquote() << QString("Unable to write to %1").arg(logFile.fileName());
+        return false;
+    }
+
+    // Quote values that would otherwise break CSV apart (e.g. Liquid app names with commas)
+    const auto toCsvLine = [](const QStringList fields) {
+        QStringList csvFields;
+        foreach (QString field, fields) {
+            if (field.contains(',') || field.contains('"') || field.contains('\n')) {
+                field = "\"" + field.replace("\"", "\"\"") + "\"";
+            }
+            csvFields << field;
+        }
+        return csvFields.join(",") + "\n";
+    };
+
+    if (isNew) {
+        logFile.write(toCsvLine(columnNames).toUtf8());
+    }
+    logFile.write(toCsvLine(values).toUtf8());
+
+    return true;
+}
+
+void Liquid::applyQtStyleSheets(void)
 {
     QString styleSheet;
 
@@ -28,7 +72,7 @@ void Liquid::applyQtStyleSheets(QWidget* widget)
     }
     // Load built-in color theme stylesheet
     {
-        QFile colorThemeStyleSheetFile(QString(":/styles/%1.qss").arg((Liquid::detectDarkMode()) ? "dark" : "light"));
+        QFile colorThemeStyleSheetFile(QString(":/styles/%1.qss").arg((LiquidThemeService::instance()->isDarkMode()) ? "dark" : "light"));
         colorThemeStyleSheetFile.open(QFile::ReadOnly);
         styleSheet += QLatin1String(colorThemeStyleSheetFile.readAll());
         colorThemeStyleSheetFile.close();
@@ -36,14 +80,32 @@ void Liquid::applyQtStyleSheets(QWidget* widget)
 
     // Load user-defined stylesheet
     {
-        QFile customStyleSheetFile(Liquid::getConfigDir().absolutePath() + QDir::separator() + PROG_NAME ".qss");
+        QFile customStyleSheetFile(Liquid::getUserStyleSheetFilePath());
         if (customStyleSheetFile.open(QFile::ReadOnly)) {
             styleSheet += QLatin1String(customStyleSheetFile.readAll());
             customStyleSheetFile.close();
         }
     }
 
-    widget->setStyleSheet(styleSheet);
+    // Applied once for the whole program, every widget and dialog simply inherits it
+    qApp->setStyleSheet(styleSheet);
+}
+
+void Liquid::applyChromiumFlags(const QString liquidAppName)
+{
+    // Only the first call counts, the web engine reads these once it gets initialized
+    static bool isApplied = false;
+    if (isApplied) {
+        return;
+    }
+    isApplied = true;
+
+    // Child processes inherit the environment, they need to see flags set by the user rather than ones this process ended up with
+    if (!qEnvironmentVariableIsSet(LQD_ENV_VAR_CHROMIUM)) {
+        qputenv(LQD_ENV_VAR_CHROMIUM, qgetenv("QTWEBENGINE_CHROMIUM_FLAGS"));
+    }
+
+    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", getChromiumFlags(liquidAppName).join(" ").toUtf8());
 }
 
 void Liquid::createDesktopFile(const QString liquidAppName, const QString liquidAppStartingUrl)
@@ -84,38 +146,6 @@ void Liquid::createDesktopFile(const QString liquidAppName, const QString liquid
 #endif
 }
 
-bool Liquid::detectDarkMode(void)
-{
-#if defined(Q_OS_LINUX)
-    QProcess process;
-    process.start("gsettings", QStringList() << "get" << "org.gnome.desktop.interface" << "gtk-theme");
-    process.waitForFinished(1000);
-    QString output = process.readAllStandardOutput();
-    if (output.size() > 0) {
-        return output.endsWith("-dark'\n", Qt::CaseInsensitive);
-    }
-#elif defined(Q_OS_MACOS)
-    static const QString macOsVer = QSysInfo::productVersion();
-    static const QStringList macOsVerParts = macOsVer.split('.');
-    if (macOsVerParts.at(0).toInt() > 10 || (macOsVerParts.at(0).toInt() >= 10 && macOsVerParts.at(1).toInt() >= 14)) {
-        bool macOsUserInterfaceIsUsingDarkMode = false;
-        CFStringRef darkStr = CFSTR("Dark");
-        CFStringRef macOsUserInterfaceStyleStr = CFSTR("AppleInterfaceStyle");
-        CFStringRef macOsUserInterfaceStyle = (CFStringRef)CFPreferencesCopyAppValue(macOsUserInterfaceStyleStr, kCFPreferencesCurrentApplication);
-        if (macOsUserInterfaceStyle != Q_NULLPTR) {
-            macOsUserInterfaceIsUsingDarkMode = (CFStringCompare(macOsUserInterfaceStyle, darkStr, 0) == kCFCompareEqualTo);
-            CFRelease(macOsUserInterfaceStyle);
-            return macOsUserInterfaceIsUsingDarkMode;
-        }
-    }
-#elif defined(Q_OS_WIN)
-    return (QSettings("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Themes\\Personalize", QSettings::NativeFormat)
-            .value("AppsUseLightTheme", 1) == 0);
-#endif
-
-    return QApplication::palette().text().color().lightnessF() > QApplication::palette().window().color().lightnessF();
-}
-
 QByteArray Liquid::generateRandomByteArray(const int byteLength)
 {
     std::vector<quint32> buf;
@@ -134,17 +164,162 @@ QDir Liquid::getAppsDir(void)
     return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_APPS_DIR_NAME + QDir::separator());
 }
 
+QStringList Liquid::getChromiumFlags(const QString liquidAppName)
+{
+    // Flag name -> value (empty for flags that don't take any)
+    QMap<QString, QString> flags;
+    // These take comma-separated lists, which get merged rather than have the last occurrence override the rest
+    QStringList enabledFeatures = QStringList() << "AutoplayIgnoreWebAudio";
+    QStringList disabledFeatures;
+    QStringList blinkSettings;
+
+    flags.insert("--enable-smooth-scrolling", QString());
+    flags.insert("--use-fake-ui-for-media-stream", QString());
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // Ensure dark mode is enabled on the web page in case the system theme is dark
+    if (LiquidThemeService::getLastKnownDarkMode()) {
+        flags.insert("--force-dark-mode", QString());
+        blinkSettings << "forceDarkModeEnabled=true" << "darkMode=4" << "darkModeEnabled=true";
+    }
+#endif
+
+    bool isGpuUsable = LiquidRenderingBackend::isGpuUsable();
+    QStringList additionalFlags;
+
+    // Liquid app's own engine settings
+    if (!liquidAppName.isEmpty()) {
+        const LiquidSettings* liquidAppConfig = LiquidSettings::forLiquidApp(liquidAppName);
+
+        // Trade some speed for memory, engine settings given explicitly still take precedence
+        if (isLowMemoryModeEnabled(liquidAppConfig)) {
+            flags.insert("--enable-low-end-device-mode", QString());
+            flags.insert("--js-flags", QString("--max-old-space-size=%1").arg(LQD_LOW_MEMORY_JS_HEAP_LIMIT));
+            flags.insert("--num-raster-threads", "1");
+            flags.insert("--renderer-process-limit", "1");
+            // Don't fetch and decode images and frames until they're about to be scrolled into view
+            enabledFeatures << "LazyFrameLoading" << "LazyImageLoading";
+            // Pages navigated away from shouldn't be kept alive in memory
+            disabledFeatures << "BackForwardCache";
+        }
+
+        // Config files can be edited by hand, anything other than a positive integer gets ignored
+        const auto getEngineSetting = [liquidAppConfig, liquidAppName](const QString key, const int min, const int max) {
+            if (!liquidAppConfig->contains(key)) {
+                return 0;
+            }
+
+            bool isNumber = false;
+            const int value = liquidAppConfig->value(key).toString().trimmed().toInt(&isNumber);
+
+            if (!isNumber || value < 1) {
+                qDebug().noquote() << QString("Ignoring invalid value of %1 for Liquid app %2").arg(key, liquidAppName);
+                return 0;
+            }
+
+            return qBound(min, value, max);
+        };
+
+        const int rasterThreadCount = getEngineSetting(LQD_CFG_KEY_NAME_ENGINE_RASTER_THREADS, 1, LQD_ENGINE_RASTER_THREADS_MAX);
+        if (rasterThreadCount > 0) {
+            flags.insert("--num-raster-threads", QString::number(rasterThreadCount));
+        }
+
+        const int rendererProcessLimit = getEngineSetting(LQD_CFG_KEY_NAME_ENGINE_RENDERER_LIMIT, 1, LQD_ENGINE_RENDERER_LIMIT_MAX);
+        if (rendererProcessLimit > 0) {
+            flags.insert("--renderer-process-limit", QString::number(rendererProcessLimit));
+        }
+
+        const int jsHeapLimit = getEngineSetting(LQD_CFG_KEY_NAME_ENGINE_JS_HEAP_LIMIT, LQD_ENGINE_JS_HEAP_LIMIT_MIN, LQD_ENGINE_JS_HEAP_LIMIT_MAX);
+        if (jsHeapLimit > 0) {
+            flags.insert("--js-flags", QString("--max-old-space-size=%1").arg(jsHeapLimit));
+        }
+
+        if (liquidAppConfig->value(LQD_CFG_KEY_NAME_ENGINE_DISABLE_GPU, false).toBool()) {
+            isGpuUsable = false;
+        }
+
+        additionalFlags << liquidAppConfig->value(LQD_CFG_KEY_NAME_ENGINE_ADDITIONAL_FLAGS).toString().simplified().split(' ');
+    }
+
+    if (!flags.contains("--num-raster-threads")) {
+        flags.insert("--num-raster-threads", QString::number(LiquidRenderingBackend::getRasterThreadCount(isGpuUsable)));
+    }
+
+    if (isGpuUsable) {
+        flags.insert("--enable-accelerated-video-decode", QString());
+        flags.insert("--enable-gpu-compositing", QString());
+        flags.insert("--enable-gpu-rasterization", QString());
+        flags.insert("--ignore-gpu-blocklist", QString());
+    } else {
+        // Have Chromium go straight for software rasterization instead of trying (and failing at) GPU first
+        flags.insert("--disable-gpu", QString());
+        flags.insert("--disable-gpu-compositing", QString());
+    }
+
+    // Whatever was set by the user for the whole environment goes last, to be able to override anything
+    const char* userChromiumFlagsEnvVar = (qEnvironmentVariableIsSet(LQD_ENV_VAR_CHROMIUM)) ? LQD_ENV_VAR_CHROMIUM : "QTWEBENGINE_CHROMIUM_FLAGS";
+    additionalFlags << QString(qgetenv(userChromiumFlagsEnvVar)).simplified().split(' ');
+    additionalFlags.removeAll(QString());
+
+    foreach (const QString additionalFlag, additionalFlags) {
+        const int separatorPosition = additionalFlag.indexOf('=');
+        const QString name = (separatorPosition > -1) ? additionalFlag.left(separatorPosition) : additionalFlag;
+        const QString value = (separatorPosition > -1) ? additionalFlag.mid(separatorPosition + 1) : QString();
+
+        if (name == "--enable-features") {
+            enabledFeatures << value.split(',');
+        } else if (name == "--disable-features") {
+            disabledFeatures << value.split(',');
+        } else if (name == "--blink-settings") {
+            blinkSettings << value.split(',');
+        } else {
+            flags.insert(name, value);
+        }
+    }
+
+    enabledFeatures.removeAll(QString());
+    enabledFeatures.removeDuplicates();
+    disabledFeatures.removeAll(QString());
+    disabledFeatures.removeDuplicates();
+    blinkSettings.removeAll(QString());
+    flags.insert("--enable-features", enabledFeatures.join(","));
+    if (disabledFeatures.size() > 0) {
+        flags.insert("--disable-features", disabledFeatures.join(","));
+    }
+    if (blinkSettings.size() > 0) {
+        flags.insert("--blink-settings", blinkSettings.join(","));
+    }
+
+    QStringList chromiumFlags;
+    for (QMap<QString, QString>::const_iterator flag = flags.constBegin(); flag != flags.constEnd(); ++flag) {
+        chromiumFlags << ((flag.value().isEmpty()) ? flag.key() : flag.key() + "=" + flag.value());
+    }
+
+    return chromiumFlags;
+}
+
 QDir Liquid::getConfigDir(void)
 {
-    const QSettings* settings = new QSettings(QSettings::IniFormat,
-                                              QSettings::UserScope,
-                                              PROG_NAME,
-                                              PROG_NAME,
-                                              Q_NULLPTR);
+    // It's not going anywhere, no need to have QSettings figure it out every time
+    static QString configDirPath;
 
-    QFileInfo settingsFileInfo(settings->fileName());
+    if (configDirPath.isEmpty()) {
+        const QSettings settings(QSettings::IniFormat,
+                                 QSettings::UserScope,
+                                 PROG_NAME,
+                                 PROG_NAME,
+                                 Q_NULLPTR);
+
+        configDirPath = QFileInfo(settings.fileName()).absolutePath();
+    }
 
-    return QDir(settingsFileInfo.absolutePath() + QDir::separator());
+    return QDir(configDirPath + QDir::separator());
+}
+
+QDir Liquid::getCookiesDir(void)
+{
+    return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_COOKIES_DIR_NAME + QDir::separator());
 }
 
 QString Liquid::getDefaultUserAgentString(void)
@@ -152,23 +327,342 @@ QString Liquid::getDefaultUserAgentString(void)
     return QWebEngineProfile().httpUserAgent();
 }
 
+QDir Liquid::getIconsDir(void)
+{
+    return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_ICONS_DIR_NAME + QDir::separator());
+}
+
+QFileInfoList Liquid::getLiquidAppsFileList(void)
+{
+    return getAppsDir().entryInfoList(QStringList() << "*.ini",
+                                      QDir::Files | QDir::NoDotAndDotDot,
+                                      QDir::Name | QDir::IgnoreCase);
+}
+
 QStringList Liquid::getLiquidAppsList(void)
 {
-    const QFileInfoList liquidAppsFileList = getAppsDir().entryInfoList(QStringList() << "*.ini",
-                                                                        QDir::Files | QDir::NoDotAndDotDot,
-                                                                        QDir::Name | QDir::IgnoreCase);
     QStringList liquidAppsNames;
-    foreach (QFileInfo liquidAppFileInfo, liquidAppsFileList) {
+    foreach (QFileInfo liquidAppFileInfo, getLiquidAppsFileList()) {
         liquidAppsNames << liquidAppFileInfo.completeBaseName();
     }
     return liquidAppsNames;
 }
 
+QList<qint64> Liquid::getLiquidProcessIds(void)
+{
+    QList<qint64> processIds;
+
+#if defined(Q_OS_LINUX)
+    const QString executableFilePath = QFileInfo(QCoreApplication::applicationFilePath()).canonicalFilePath();
+
+    foreach (const QString entry, QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool isProcessId = false;
+        const qint64 processId = entry.toLongLong(&isProcessId);
+
+        if (isProcessId && QFileInfo(QString("/proc/%1/exe").arg(processId)).canonicalFilePath() == executableFilePath) {
+            processIds << processId;
+        }
+    }
+#endif
+
+    return processIds;
+}
+
+QDir Liquid::getLogsDir(void)
+{
+    return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_LOGS_DIR_NAME + QDir::separator());
+}
+
+qint64 Liquid::getProcessCpuTime(const qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    // Time spent in user and kernel modes, in clock ticks
+    const QList<QByteArray> fields = getProcessStatFields(pid);
+    if (fields.size() > 12) {
+        return (fields.at(11).toLongLong() + fields.at(12).toLongLong()) * 1000 / sysconf(_SC_CLK_TCK);
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+
+    return -1;
+}
+
+qint64 Liquid::getProcessMemoryUsage(const qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    // Proportional set size splits shared pages (libraries, the web engine itself) between processes using them,
+    // which makes numbers for separate processes add up; it's not available on older kernels, resident set size is
+    const qint64 proportionalSetSize = getProcessStatusValue(pid, "smaps_rollup", "Pss:");
+    if (proportionalSetSize > -1) {
+        return proportionalSetSize;
+    }
+#endif
+
+    return getProcessResidentSetSize(pid);
+}
+
+qint64 Liquid::getProcessResidentSetSize(const qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    return getProcessStatusValue(pid, "status", "VmRSS:");
+#else
+    Q_UNUSED(pid);
+
+    return -1;
+#endif
+}
+
+qint64 Liquid::getProcessStatusValue(const qint64 pid, const QString fileName, const QByteArray key)
+{
+#if defined(Q_OS_LINUX)
+    QFile file(QString("/proc/%1/%2").arg(pid).arg(fileName));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    foreach (const QByteArray line, file.readAll().split('\n')) {
+        if (line.startsWith(key)) {
+            // e.g.: "Pss:  123456 kB"
+            return line.mid(key.size()).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+    }
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(fileName);
+    Q_UNUSED(key);
+#endif
+
+    return -1;
+}
+
+QList<qint64> Liquid::getProcessTreeIds(const qint64 pid)
+{
+    QList<qint64> processTreeIds = QList<qint64>() << pid;
+
+#if defined(Q_OS_LINUX)
+    QMultiHash<qint64, qint64> childProcessIds;
+    foreach (const QString entry, QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool isProcessId = false;
+        const qint64 processId = entry.toLongLong(&isProcessId);
+        if (!isProcessId) {
+            continue;
+        }
+
+        // Parent's ID is the second field following the process name
+        const QList<QByteArray> fields = getProcessStatFields(processId);
+        if (fields.size() > 1) {
+            childProcessIds.insert(fields.at(1).toLongLong(), processId);
+        }
+    }
+
+    for (int i = 0; i < processTreeIds.size(); i++) {
+        processTreeIds << childProcessIds.values(processTreeIds.at(i));
+    }
+#endif
+
+    return processTreeIds;
+}
+
+qint64 Liquid::getProcessTreeMemoryUsage(const qint64 pid)
+{
+    qint64 total = 0;
+
+    // Web engine's own processes (GPU, renderers, etc) are all descendants of the one that started it
+    foreach (const qint64 processId, getProcessTreeIds(pid)) {
+        const qint64 memoryUsage = getProcessMemoryUsage(processId);
+
+        if (memoryUsage > 0) {
+            total += memoryUsage;
+        }
+    }
+
+    return (total > 0) ? total : -1;
+}
+
+QList<QByteArray> Liquid::getProcessStatFields(const qint64 pid)
+{
+#if defined(Q_OS_LINUX)
+    QFile statFile(QString("/proc/%1/stat").arg(pid));
+    if (statFile.open(QIODevice::ReadOnly)) {
+        // Process name may contain spaces and parentheses, only what comes after it can be split safely
+        const QByteArray stat = statFile.readAll().trimmed();
+        return stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+
+    return QList<QByteArray>();
+}
+
 QString Liquid::getReadableDateTimeString(void)
 {
     return QDateTime::currentDateTimeUtc().toString(QLocale().dateTimeFormat());
 }
 
+QString Liquid::getReadableMemoryUsage(const qint64 bytes)
+{
+    if (bytes < 0) {
+        return QString("unknown");
+    }
+
+    return QString("%1 MiB").arg(bytes / 1048576.0, 0, 'f', 1);
+}
+
+QDir Liquid::getRuntimeDir(void)
+{
+    const QString runtimeDirPath = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+
+    if (!runtimeDirPath.isEmpty()) {
+        return QDir(runtimeDirPath + QDir::separator() + PROG_NAME + QDir::separator());
+    }
+
+    // Unlike the runtime directory, the temporary one may be shared with other users,
+    // nobody else should be able to look into or put anything within this user's directory in there
+    const QString tempRuntimeDirPath = QDir::tempPath() + QDir::separator() + PROG_NAME + "-" + getUserName();
+    static bool isTempRuntimeDirReady = false;
+
+    if (!isTempRuntimeDirReady) {
+        QDir().mkpath(tempRuntimeDirPath);
+        QFile::setPermissions(tempRuntimeDirPath, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ExeOwner);
+        isTempRuntimeDirReady = true;
+    }
+
+#if defined(Q_OS_LINUX)
+    // Made by someone else before this user got to it
+    if (QFileInfo(tempRuntimeDirPath).ownerId() != getuid()) {
+        qDebug().noquote() << QString("Directory %1 belongs to another user, using %2 instead").arg(tempRuntimeDirPath).arg(getConfigDir().absolutePath());
+        return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_RUNTIME_DIR_NAME + QDir::separator());
+    }
+#endif
+
+    return QDir(tempRuntimeDirPath + QDir::separator());
+}
+
+QDir Liquid::getSnapshotsDir(void)
+{
+    return QDir(getConfigDir().absolutePath() + QDir::separator() + LQD_SNAPSHOTS_DIR_NAME + QDir::separator());
+}
+
+QString Liquid::getUserName(void)
+{
+    QString name = qgetenv("USER");
+
+    if (name.isEmpty()) {
+        name = qgetenv("USERNAME");
+    }
+
+    return name;
+}
+
+QString Liquid::getUserStyleSheetFilePath(void)
+{
+    return getConfigDir().absolutePath() + QDir::separator() + PROG_NAME ".qss";
+}
+
+bool Liquid::isLowMemoryModeEnabled(const LiquidSettings* liquidAppConfig)
+{
+    // Lets the same Liquid app be measured both ways (see liquid --memory-report)
+    if (qEnvironmentVariableIsSet(LQD_ENV_VAR_LOW_MEMORY)) {
+        return qgetenv(LQD_ENV_VAR_LOW_MEMORY) == "1";
+    }
+
+    return liquidAppConfig->value(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE, false).toBool();
+}
+
+bool Liquid::listenOnLocalSocket(QLocalServer* server, const QString serverName, bool* isInUse)
+{
+    *isInUse = false;
+
+    if (server->listen(serverName)) {
+        return true;
+    }
+
+    const auto isListenedOn = [serverName]() {
+        QLocalSocket socket;
+        socket.connectToServer(serverName);
+        return socket.waitForConnected(LQD_LAUNCHER_CONNECT_TIMEOUT);
+    };
+
+    // Processes starting at the same time could otherwise remove each other's socket, taking it for a leftover
+    QDir().mkpath(getRuntimeDir().absolutePath());
+    QLockFile lockFile(getRuntimeDir().absolutePath() + QDir::separator() + serverName + ".lock");
+    if (!lockFile.tryLock(LQD_LAUNCHER_REPLY_TIMEOUT)) {
+        // Whoever holds it is about to start listening
+        *isInUse = isListenedOn() || lockFile.error() == QLockFile::LockFailedError;
+        return false;
+    }
+
+    // Could have been cleaned up (or taken) while waiting for the lock
+    if (server->listen(serverName)) {
+        return true;
+    }
+
+    if (isListenedOn()) {
+        *isInUse = true;
+        return false;
+    }
+
+    // Must be a leftover from a process that didn't quit properly
+    QLocalServer::removeServer(serverName);
+    if (server->listen(serverName)) {
+        return true;
+    }
+
+    *isInUse = isListenedOn();
+
+    return false;
+}
+
+qint64 Liquid::measureLiquidAppMemoryUsage(const QString liquidAppName, const bool lowMemoryMode)
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(LQD_ENV_VAR_LOW_MEMORY, (lowMemoryMode) ? "1" : "0");
+
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setProgram(QCoreApplication::applicationFilePath());
+    process.setArguments(QStringList() << liquidAppName);
+    process.start();
+
+    if (!process.waitForStarted()) {
+        return -1;
+    }
+
+    // Give the web page a chance to load and settle down; quitting before then means something went wrong
+    if (process.waitForFinished(LQD_MEMORY_REPORT_SETTLE_TIME)) {
+        return -1;
+    }
+
+    // Average out short-lived spikes (e.g. garbage collection)
+    qint64 memoryUsageSum = 0;
+    int sampleCount = 0;
+    for (int i = 0; i < LQD_MEMORY_REPORT_SAMPLE_COUNT; i++) {
+        const qint64 memoryUsage = getProcessTreeMemoryUsage(process.processId());
+
+        if (memoryUsage > 0) {
+            memoryUsageSum += memoryUsage;
+            sampleCount++;
+        }
+
+        if (process.waitForFinished(LQD_MEMORY_REPORT_SAMPLE_INTERVAL)) {
+            break;
+        }
+    }
+
+    // Let the Liquid app quit properly, so that it saves its settings and cookies
+    if (process.state() != QProcess::NotRunning) {
+        process.terminate();
+        if (!process.waitForFinished()) {
+            process.kill();
+            process.waitForFinished();
+        }
+    }
+
+    return (sampleCount > 0) ? memoryUsageSum / sampleCount : -1;
+}
+
 void Liquid::removeDesktopFile(const QString liquidAppName)
 {
 #if defined(Q_OS_LINUX)
@@ -190,9 +684,52 @@ void Liquid::removeDesktopFile(const QString liquidAppName)
 
 void Liquid::runLiquidApp(const QString liquidAppName)
 {
+    // Simply bring it up if it's running already
+    if (LiquidInstanceServer::requestActivation(liquidAppName)) {
+        return;
+    }
+
+    // Let the app host run it alongside other Liquid apps if there's one running
+    if (LiquidAppHost::requestLaunch(liquidAppName)) {
+        return;
+    }
+
+    // Let the launcher daemon take care of it if there's one running
+    if (LiquidLauncherDaemon::requestLaunch(liquidAppName)) {
+        return;
+    }
+
     QProcess::startDetached(QCoreApplication::applicationFilePath(), QStringList() << QStringLiteral("%1").arg(liquidAppName));
 }
 
+bool Liquid::shredFile(const QString filePath)
+{
+    QFile file(filePath);
+
+    // Open file handle
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    // Determine file length
+    const int fileSize = file.size();
+    // Shred (especially important if it contains Cookie data)
+    for (int i = 0, imax = 5; i < imax; i++) {
+        // Write randomly generated array of bytes to disk
+        file.write(Liquid::generateRandomByteArray(fileSize), fileSize);
+        // Close file handle
+        file.close();
+
+        if (i < imax - 1) {
+            // Put cursor back to start (to write again across the same byte range instead of appending data upon next iteration)
+            file.open(QIODevice::ReadWrite);
+        }
+    }
+
+    // Unlink file
+    return file.remove();
+}
+
 void Liquid::sleep(const int ms)
 {
     const QTime proceedAfter = QTime::currentTime().addMSecs(ms);
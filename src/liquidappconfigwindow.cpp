@@ -4,6 +4,9 @@
 
 #include "liquid.hpp"
 #include "liquidappconfigwindow.hpp"
+#include "liquidappcookiestore.hpp"
+#include "liquidappwindow.hpp"
+#include "liquidsettings.hpp"
 #include "lqd.h"
 #include "mainwindow.hpp"
 
@@ -13,20 +16,13 @@ LiquidAppConfigDialog::LiquidAppConfigDialog(QWidget* parent, QString liquidAppN
 
     liquidAppName = liquidAppName.replace(QDir::separator(), "_");
 
-    Liquid::applyQtStyleSheets(this);
-
     // Attempt to load liquid app's config file
-    QSettings* existingLiquidAppConfig = new QSettings(QSettings::IniFormat,
-                                                       QSettings::UserScope,
-                                                       QString(PROG_NAME "%1" LQD_APPS_DIR_NAME).arg(QDir::separator()),
-                                                       liquidAppName,
-                                                       Q_NULLPTR);
+    LiquidSettings* existingLiquidAppConfig = Q_NULLPTR;
 
     // Check to see if Liquid app by this name already has config file
     if (liquidAppName.size() > 0) {
+        existingLiquidAppConfig = LiquidSettings::forLiquidApp(liquidAppName);
         isEditingExistingBool = existingLiquidAppConfig->contains(LQD_CFG_KEY_NAME_URL);
-    } else {
-        delete existingLiquidAppConfig;
     }
 
     if (isEditingExistingBool) {
@@ -553,27 +549,19 @@ LiquidAppConfigDialog::LiquidAppConfigDialog(QWidget* parent, QString liquidAppN
 
                 // Fill model items
                 if (isEditingExistingBool) {
-                    existingLiquidAppConfig->beginGroup(LQD_CFG_GROUP_NAME_COOKIES);
                     int i = 0;
-                    foreach(QString cookieId, existingLiquidAppConfig->allKeys()) {
-                        const QByteArray rawCookie = existingLiquidAppConfig->value(cookieId).toByteArray();
-                        QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(rawCookie);
-                        if (cookies.size() > 0) {
-                            QNetworkCookie cookie = cookies[0];
-
-                            cookiesModel->appendRow(new QStandardItem());
-                            cookiesModel->setItem(i, 0, new QStandardItem(QString(cookie.name())));
-                            cookiesModel->setItem(i, 1, new QStandardItem(QString(cookie.value())));
-                            cookiesModel->setItem(i, 2, new QStandardItem(cookie.domain()));
-                            cookiesModel->setItem(i, 3, new QStandardItem(cookie.path()));
-                            cookiesModel->setItem(i, 4, new QStandardItem(cookie.expirationDate().toString()));
-                            cookiesModel->setItem(i, 5, new QStandardItem(cookie.isHttpOnly() ? "true" : "false"));
-                            cookiesModel->setItem(i, 6, new QStandardItem(cookie.isSecure() ? "true" : "false"));
-
-                            i++;
-                        }
+                    foreach(QNetworkCookie cookie, LiquidAppCookieStore::readCookies(liquidAppName, existingLiquidAppConfig)) {
+                        cookiesModel->appendRow(new QStandardItem());
+                        cookiesModel->setItem(i, 0, new QStandardItem(QString(cookie.name())));
+                        cookiesModel->setItem(i, 1, new QStandardItem(QString(cookie.value())));
+                        cookiesModel->setItem(i, 2, new QStandardItem(cookie.domain()));
+                        cookiesModel->setItem(i, 3, new QStandardItem(cookie.path()));
+                        cookiesModel->setItem(i, 4, new QStandardItem(cookie.expirationDate().toString()));
+                        cookiesModel->setItem(i, 5, new QStandardItem(cookie.isHttpOnly() ? "true" : "false"));
+                        cookiesModel->setItem(i, 6, new QStandardItem(cookie.isSecure() ? "true" : "false"));
+
+                        i++;
                     }
-                    existingLiquidAppConfig->endGroup();
                 }
             }
 
@@ -770,6 +758,111 @@ LiquidAppConfigDialog::LiquidAppConfigDialog(QWidget* parent, QString liquidAppN
         }
     }
 
+    /////////////////////
+    // Performance tab //
+    /////////////////////
+
+    {
+        QWidget* performanceTabWidget = new QWidget(this);
+        QVBoxLayout* performanceTabWidgetLayout = new QVBoxLayout();
+        performanceTabWidget->setLayout(performanceTabWidgetLayout);
+        tabWidget->addTab(performanceTabWidget, tr("Performance"));
+
+        // Low-memory mode checkbox
+        {
+            lowMemoryModeCheckBox = new QCheckBox(tr("Low-memory mode"), this);
+            lowMemoryModeCheckBox->setCursor(Qt::PointingHandCursor);
+            lowMemoryModeCheckBox->setToolTip(tr("Use less memory at the cost of speed, best suited for simple pages.\n"
+                                                 "Back/forward history gets cleared once it has over %1 pages in it.")
+                                                 .arg(LQD_LOW_MEMORY_HISTORY_LIMIT * 2));
+
+            if (isEditingExistingBool) {
+                if (existingLiquidAppConfig->contains(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE)) {
+                    lowMemoryModeCheckBox->setChecked(
+                        existingLiquidAppConfig->value(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE).toBool()
+                    );
+                }
+            }
+
+            performanceTabWidgetLayout->addWidget(lowMemoryModeCheckBox);
+        }
+
+        // Background lifecycle
+        {
+            performanceTabWidgetLayout->addWidget(separator());
+
+            QGridLayout* lifecycleLayout = new QGridLayout();
+
+            // Freeze delay
+            {
+                QLabel* freezeDelayLabel = new QLabel(tr("Freeze page after being hidden for:"), this);
+
+                freezeDelayInput = new QSpinBox(this);
+                freezeDelayInput->setRange(0, 24 * 60);
+                freezeDelayInput->setSuffix(tr(" min"));
+                freezeDelayInput->setSpecialValueText(tr("Never"));
+                freezeDelayInput->setToolTip(tr("Stops timers and scripts of the page while the window is hidden"));
+
+                if (isEditingExistingBool) {
+                    freezeDelayInput->setValue(
+                        existingLiquidAppConfig->value(LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY, LQD_LIFECYCLE_FREEZE_DELAY).toInt() / 60
+                    );
+                }
+
+                lifecycleLayout->addWidget(freezeDelayLabel, 0, 0);
+                lifecycleLayout->addWidget(freezeDelayInput, 0, 1);
+            }
+
+            // Discard delay
+            {
+                QLabel* discardDelayLabel = new QLabel(tr("Discard page after being hidden for:"), this);
+
+                discardDelayInput = new QSpinBox(this);
+                discardDelayInput->setRange(0, 24 * 60);
+                discardDelayInput->setSuffix(tr(" min"));
+                discardDelayInput->setSpecialValueText(tr("Never"));
+                discardDelayInput->setToolTip(tr("Frees the page's memory while the window is hidden, it gets reloaded once shown again"));
+
+                if (isEditingExistingBool) {
+                    discardDelayInput->setValue(
+                        existingLiquidAppConfig->value(LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY, LQD_LIFECYCLE_DISCARD_DELAY).toInt() / 60
+                    );
+                }
+
+                lifecycleLayout->addWidget(discardDelayLabel, 1, 0);
+                lifecycleLayout->addWidget(discardDelayInput, 1, 1);
+            }
+
+            performanceTabWidgetLayout->addLayout(lifecycleLayout);
+        }
+
+        // Show splash checkbox
+        {
+            performanceTabWidgetLayout->addWidget(separator());
+
+            showSplashCheckBox = new QCheckBox(tr("Show last seen contents while starting up"), this);
+            showSplashCheckBox->setCursor(Qt::PointingHandCursor);
+            showSplashCheckBox->setToolTip(tr("Keeps a picture of the window's contents on disk (unencrypted) until the next start"));
+
+            if (isEditingExistingBool) {
+                if (existingLiquidAppConfig->contains(LQD_CFG_KEY_NAME_SHOW_SPLASH)) {
+                    showSplashCheckBox->setChecked(
+                        existingLiquidAppConfig->value(LQD_CFG_KEY_NAME_SHOW_SPLASH).toBool()
+                    );
+                }
+            }
+
+            performanceTabWidgetLayout->addWidget(showSplashCheckBox);
+        }
+
+        // Spacer
+        {
+            QWidget* spacer = new QWidget(this);
+            spacer->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Expanding);
+            performanceTabWidgetLayout->addWidget(spacer);
+        }
+    }
+
     mainLayout->addWidget(advancedWidget);
 
     setLayout(mainLayout);
@@ -814,11 +907,7 @@ void LiquidAppConfigDialog::save()
         return;
     }
 
-    QSettings* tempLiquidAppConfig = new QSettings(QSettings::IniFormat,
-                                                   QSettings::UserScope,
-                                                   QString(PROG_NAME) + QDir::separator() + LQD_APPS_DIR_NAME,
-                                                   appName,
-                                                   Q_NULLPTR);
+    LiquidSettings* tempLiquidAppConfig = LiquidSettings::forLiquidApp(appName);
 
     // URL
     {
@@ -1153,7 +1242,75 @@ void LiquidAppConfigDialog::save()
         }
     }
 
+    // Low-memory mode
+    {
+        if (isEditingExistingBool) {
+            if (tempLiquidAppConfig->contains(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE) && !lowMemoryModeCheckBox->isChecked()) {
+                 tempLiquidAppConfig->remove(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE);
+            } else {
+                if (lowMemoryModeCheckBox->isChecked()) {
+                    tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE, true);
+                }
+            }
+        } else {
+            if (lowMemoryModeCheckBox->isChecked()) {
+                tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_LOW_MEMORY_MODE, true);
+            }
+        }
+    }
+
+    // Background lifecycle
+    {
+        // Freeze delay
+        {
+            if (freezeDelayInput->value() == 0) {
+                if (isEditingExistingBool && tempLiquidAppConfig->contains(LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY)) {
+                     tempLiquidAppConfig->remove(LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY);
+                }
+            } else {
+                tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY, freezeDelayInput->value() * 60);
+            }
+        }
+
+        // Discard delay
+        {
+            if (discardDelayInput->value() == 0) {
+                if (isEditingExistingBool && tempLiquidAppConfig->contains(LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY)) {
+                     tempLiquidAppConfig->remove(LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY);
+                }
+            } else {
+                tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY, discardDelayInput->value() * 60);
+            }
+        }
+    }
+
+    // Show splash
+    {
+        if (isEditingExistingBool) {
+            if (tempLiquidAppConfig->contains(LQD_CFG_KEY_NAME_SHOW_SPLASH) && !showSplashCheckBox->isChecked()) {
+                 tempLiquidAppConfig->remove(LQD_CFG_KEY_NAME_SHOW_SPLASH);
+            } else {
+                if (showSplashCheckBox->isChecked()) {
+                    tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_SHOW_SPLASH, true);
+                }
+            }
+        } else {
+            if (showSplashCheckBox->isChecked()) {
+                tempLiquidAppConfig->setValue(LQD_CFG_KEY_NAME_SHOW_SPLASH, true);
+            }
+        }
+
+        // Shouldn't stay around once turned off
+        const QString splashFilePath = LiquidAppWindow::getSplashFilePath(appName);
+        if (!showSplashCheckBox->isChecked() && QFile::exists(splashFilePath) && !Liquid::shredFile(splashFilePath)) {
+            qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(splashFilePath);
+        }
+    }
+
+    // The main window reads it right back, and the Liquid app may get started by another process;
+    // both expect the file to be written by the time the dialog is gone
     tempLiquidAppConfig->sync();
+    LiquidSettings::waitForFlush();
 
     accept();
 }
@@ -1,3 +1,8 @@
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QTimer>
+
 #include "lqd.h"
 #include "liquidappcookiejar.hpp"
 #include "liquidappwindow.hpp"
@@ -6,109 +11,242 @@ LiquidAppCookieJar::LiquidAppCookieJar(QObject *parent) : QNetworkCookieJar(pare
 {
     liquidAppWindow = (LiquidAppWindow*)parent;
     liquidAppConfig = liquidAppWindow->liquidAppConfig;
+
+    const QString liquidAppName = QFileInfo(liquidAppConfig->fileName()).completeBaseName();
+    liquidAppCookieStore = new LiquidAppCookieStore(liquidAppName, this);
+
+    allowCookies = liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool();
+    allowThirdPartyCookies = liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_3RD_PARTY_COOKIES).toBool();
+
+    // Re-read cookie policy only when the app's config file gets modified (e.g. via the edit dialog)
+    liquidAppConfigWatcher = new QFileSystemWatcher(QStringList() << liquidAppConfig->fileName(), this);
+    connect(liquidAppConfigWatcher, &QFileSystemWatcher::fileChanged, this, &LiquidAppCookieJar::reloadConfig);
+    connect(liquidAppConfig, &LiquidSettings::reloaded, this, &LiquidAppCookieJar::refreshPolicy);
+
+    // Keep the web engine in sync with what the cookie store decided to get rid of
+    connect(liquidAppCookieStore, &LiquidAppCookieStore::cookiesEvicted, this, &LiquidAppCookieJar::evictCookies);
 }
 
 LiquidAppCookieJar::~LiquidAppCookieJar(void)
 {
 }
 
+QList<QNetworkCookie> LiquidAppCookieJar::allCookies(void) const
+{
+    return cookies.values();
+}
+
+QList<QNetworkCookie> LiquidAppCookieJar::cookiesForUrl(const QUrl& url) const
+{
+    QList<QNetworkCookie> urlCookies;
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const bool isSecureUrl = url.scheme() == "https" || url.scheme() == "wss";
+    const QString host = url.host();
+    const QString path = (url.path().isEmpty()) ? "/" : url.path();
+
+    foreach (const QNetworkCookie cookie, cookies) {
+        QString domain(cookie.domain());
+        while (domain.startsWith(".")) {
+            domain = domain.right(domain.size() - 1);
+        }
+
+        if (!cookie.isSessionCookie() && cookie.expirationDate() <= now) {
+            continue;
+        }
+
+        if (cookie.isSecure() && !isSecureUrl) {
+            continue;
+        }
+
+        if (host != domain && !host.endsWith("." + domain)) {
+            continue;
+        }
+
+        // Path has to match either exactly or up to a slash
+        if (!cookie.path().isEmpty() && path != cookie.path()
+            && !(path.startsWith(cookie.path()) && (cookie.path().endsWith("/") || path.at(cookie.path().size()) == '/'))
+        ) {
+            continue;
+        }
+
+        urlCookies.append(cookie);
+    }
+
+    return urlCookies;
+}
+
+bool LiquidAppCookieJar::deleteCookie(const QNetworkCookie& cookie)
+{
+    return removeCookie(cookie);
+}
+
+void LiquidAppCookieJar::evictCookies(const QList<QNetworkCookie> evictedCookies)
+{
+    foreach (QNetworkCookie cookie, evictedCookies) {
+        cookies.remove(LiquidAppCookieStore::getCookieId(cookie));
+
+        if (webEngineCookieStore != Q_NULLPTR) {
+            const QUrl url = getCookieOriginUrl(cookie);
+            // Avoid prepending leading dot (https://bugreports.qt.io/browse/QTBUG-64732)
+            if (!cookie.domain().startsWith(".")) {
+                cookie.setDomain("");
+            }
+            webEngineCookieStore->deleteCookie(cookie, url);
+        }
+    }
+}
+
+QUrl LiquidAppCookieJar::getCookieOriginUrl(const QNetworkCookie& cookie)
+{
+    // Construct origin URL based on cookie data
+    QString scheme("http");
+    if (cookie.isSecure()) {
+        scheme += "s";
+    }
+    QString domain(cookie.domain());
+    while (domain.startsWith(".")) {
+        domain = domain.right(domain.size() - 1);
+    }
+
+    return QUrl(scheme + "://" + domain + cookie.path());
+}
+
+bool LiquidAppCookieJar::insertCookie(const QNetworkCookie& cookie)
+{
+    return upsertCookie(cookie);
+}
+
+void LiquidAppCookieJar::refreshPolicy(void)
+{
+    allowCookies = liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool();
+    allowThirdPartyCookies = liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_3RD_PARTY_COOKIES).toBool();
+}
+
+void LiquidAppCookieJar::reloadConfig(void)
+{
+    // Config files get replaced rather than modified in place, the watcher needs to be pointed at the new file
+    if (!liquidAppConfigWatcher->files().contains(liquidAppConfig->fileName())) {
+        liquidAppConfigWatcher->addPath(liquidAppConfig->fileName());
+    }
+
+    // Pick up changes made by other processes (e.g. Liquid app's config dialog), writes of its own get skipped
+    liquidAppConfig->reload();
+}
+
 bool LiquidAppCookieJar::upsertCookie(const QNetworkCookie &cookie)
 {
-    if (!liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool()) {
+    if (!allowCookies) {
         return false;
     }
 
     const bool isThirdParty = !validateCookie(cookie, liquidAppWindow->url());
-    if (isThirdParty && !liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_3RD_PARTY_COOKIES).toBool()) {
+    if (isThirdParty && !allowThirdPartyCookies) {
         return false;
     }
 
-    foreach(QNetworkCookie existingCookie, allCookies()) {
-        if (existingCookie.hasSameIdentifier(cookie)) {
-            deleteCookie(existingCookie);
-        }
+    const QByteArray cookieId = LiquidAppCookieStore::getCookieId(cookie);
+
+    // The web engine reports the same cookie over and over again, e.g. when it gets restored
+    QHash<QByteArray, QNetworkCookie>::const_iterator existingCookie = cookies.constFind(cookieId);
+    if (existingCookie != cookies.constEnd() && *existingCookie == cookie) {
+        return true;
     }
 
-    const bool inserted = insertCookie(cookie);
+    cookies.insert(cookieId, cookie);
+    liquidAppCookieStore->upsertCookie(cookie);
 
-    if (inserted) {
-        save();
-    }
+    return true;
+}
 
-    return inserted;
+bool LiquidAppCookieJar::updateCookie(const QNetworkCookie& cookie)
+{
+    return upsertCookie(cookie);
 }
 
 bool LiquidAppCookieJar::removeCookie(const QNetworkCookie &cookie)
 {
-    if (!liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool()) {
+    if (!allowCookies) {
         return false;
     }
 
     const bool isThirdParty = !validateCookie(cookie, liquidAppWindow->url());
-    if (isThirdParty && !liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_3RD_PARTY_COOKIES).toBool()) {
+    if (isThirdParty && !allowThirdPartyCookies) {
         return false;
     }
 
-    const bool deleted = deleteCookie(cookie);
+    const bool deleted = cookies.remove(LiquidAppCookieStore::getCookieId(cookie)) > 0;
 
     if (deleted) {
-        save();
+        liquidAppCookieStore->removeCookie(cookie);
     }
 
     return deleted;
 }
 
-void LiquidAppCookieJar::restoreCookies(QWebEngineCookieStore *cookieStore) {
-    if (liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool()) {
-        liquidAppConfig->beginGroup(LQD_CFG_GROUP_NAME_COOKIES);
-        foreach(QString cookieId, liquidAppConfig->allKeys()) {
-            const QByteArray rawCookie = liquidAppConfig->value(cookieId).toByteArray();
-            const QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(rawCookie);
-            if (cookies.size() > 0) {
-                QNetworkCookie cookie = cookies[0];
-
-                // Construct origin URL based on cookie data
-                QString scheme("http");
-                if (cookie.isSecure()) {
-                    scheme += "s";
-                }
-                QString domain(cookie.domain());
-                while (domain.startsWith(".")) {
-                    domain = domain.right(domain.size() - 1);
-                }
-                QUrl url(scheme + "://" + domain + cookie.path());
-
-                // Avoid prepending leading dot (https://bugreports.qt.io/browse/QTBUG-64732)
-                if (!cookie.domain().startsWith(".")) {
-                    cookie.setDomain("");
-                }
-                cookieStore->setCookie(cookie, url);
-            }
-        }
-        liquidAppConfig->endGroup();
+void LiquidAppCookieJar::restoreCookie(QNetworkCookie cookie)
+{
+    const QUrl url = getCookieOriginUrl(cookie);
+
+    // Avoid prepending leading dot (https://bugreports.qt.io/browse/QTBUG-64732)
+    if (!cookie.domain().startsWith(".")) {
+        cookie.setDomain("");
     }
+    webEngineCookieStore->setCookie(cookie, url);
 }
 
-void LiquidAppCookieJar::save(void)
+void LiquidAppCookieJar::restoreCookies(QWebEngineCookieStore *cookieStore, const QUrl startingUrl)
 {
-    if (!liquidAppConfig->value(LQD_CFG_KEY_NAME_ALLOW_COOKIES).toBool()) {
+    webEngineCookieStore = cookieStore;
+
+    if (!allowCookies) {
+        emit startingUrlCookiesRestored();
         return;
     }
 
-    liquidAppConfig->beginGroup(LQD_CFG_GROUP_NAME_COOKIES);
-    // Remove all cookies
-    foreach(QString cookieName, liquidAppConfig->allKeys()) {
-        liquidAppConfig->remove(cookieName);
+    // Read and parse stored cookies off the GUI thread
+    QFutureWatcher<LiquidAppCookieStore::Contents>* cookieStoreReadWatcher = new QFutureWatcher<LiquidAppCookieStore::Contents>(this);
+
+    connect(cookieStoreReadWatcher, &QFutureWatcher<LiquidAppCookieStore::Contents>::finished, this, [this, cookieStoreReadWatcher, startingUrl](){
+        const QString startingHost = startingUrl.host();
+
+        foreach(QNetworkCookie cookie, liquidAppCookieStore->load(cookieStoreReadWatcher->result(), liquidAppConfig)) {
+            QString domain(cookie.domain());
+            while (domain.startsWith(".")) {
+                domain = domain.right(domain.size() - 1);
+            }
+
+            // Cookies that belong to the starting URL's host are the only ones the first navigation has to wait for
+            if (domain.isEmpty() || startingHost == domain || startingHost.endsWith("." + domain)) {
+                restoreCookie(cookie);
+            } else {
+                cookiesToRestore.append(cookie);
+            }
+        }
+
+        cookieStoreReadWatcher->deleteLater();
+
+        emit startingUrlCookiesRestored();
+
+        restoreCookiesBatch();
+    });
+
+    cookieStoreReadWatcher->setFuture(liquidAppCookieStore->read());
+}
+
+void LiquidAppCookieJar::restoreCookiesBatch(void)
+{
+    for (int i = 0; i < LQD_COOKIES_RESTORE_BATCH_SIZE && !cookiesToRestore.isEmpty(); i++) {
+        const QNetworkCookie cookie = cookiesToRestore.takeFirst();
+
+        // Don't overwrite cookies that the page has already set by now
+        if (!cookies.contains(LiquidAppCookieStore::getCookieId(cookie))) {
+            restoreCookie(cookie);
+        }
     }
-    // Save all cookies
-    foreach(QNetworkCookie cookie, allCookies()) {
-        QByteArray cookieId = QByteArray(cookie.domain().toLatin1() +
-                                         "_" + cookie.path().toLatin1() +
-                                         "_" + cookie.name());
-        QString rawCookie = QString(cookie.toRawForm(QNetworkCookie::Full));
-        // TODO: save Session cookies?
-        liquidAppConfig->setValue(cookieId, rawCookie);
+
+    // Let the event loop breathe between batches
+    if (!cookiesToRestore.isEmpty()) {
+        QTimer::singleShot(0, this, &LiquidAppCookieJar::restoreCookiesBatch);
     }
-    liquidAppConfig->endGroup();
-    liquidAppConfig->sync();
 }
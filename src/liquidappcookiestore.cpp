@@ -0,0 +1,595 @@
+#include <algorithm>
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QUrl>
+#include <QtConcurrent>
+
+#if defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+#include "liquid.hpp"
+#include "liquidappcookiestore.hpp"
+#include "lqd.h"
+
+/*
+ * Cookies are kept in two files:
+ *
+ * <app>.cookies is a binary snapshot of pre-parsed cookies, written atomically during compaction.
+ *
+ * <app>.journal holds changes made since the snapshot was written, one record per line:
+ *   +<base64 cookie ID> <base64 raw cookie> <time set, ms since epoch>
+ *   -<base64 cookie ID>
+ * Records get replayed in order on top of the snapshot, the last one for any given cookie ID wins.
+ * A line without its trailing newline is a torn write and gets ignored.
+ */
+static const char journalOpUpsert = '+';
+static const char journalOpRemove = '-';
+
+static const quint32 snapshotMagic = 0x4c51434b; // "LQCK"
+static const quint16 snapshotVersion = 2; // 2 added time set to every cookie
+
+LiquidAppCookieStore::LiquidAppCookieStore(const QString liquidAppName, QObject* parent) : QObject(parent)
+{
+    this->liquidAppName = liquidAppName;
+    journalFilePath = getJournalFilePath(liquidAppName);
+    snapshotFilePath = getSnapshotFilePath(liquidAppName);
+
+    // Coalesce bursts of cookie changes (e.g. sign-in flows) into a single write
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(LQD_COOKIES_JOURNAL_FLUSH_DELAY);
+    connect(flushTimer, &QTimer::timeout, this, &LiquidAppCookieStore::flush);
+
+    // Periodically get rid of expired and excessive cookies (started once the store is loaded)
+    garbageCollectionTimer = new QTimer(this);
+    garbageCollectionTimer->setInterval(LQD_COOKIES_GC_INTERVAL);
+    connect(garbageCollectionTimer, &QTimer::timeout, this, &LiquidAppCookieStore::collectGarbage);
+}
+
+LiquidAppCookieStore::~LiquidAppCookieStore(void)
+{
+    flush();
+}
+
+void LiquidAppCookieStore::appendRecord(const QByteArray& record)
+{
+    pendingRecords.append(record);
+    contents.journalRecordCount++;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void LiquidAppCookieStore::collectGarbage(void)
+{
+    int expiredCount = 0;
+    const QList<QNetworkCookie> evictedCookies = purge(&expiredCount);
+
+    if (evictedCookies.isEmpty()) {
+        return;
+    }
+
+    qint64 reclaimedBytes = 0;
+    compact(&reclaimedBytes);
+
+    qDebug().noquote() << QString("Cookie store of Liquid app “%1”: dropped %2 expired and %3 over-limit cookies, reclaimed %4 bytes")
+                              .arg(liquidAppName)
+                              .arg(expiredCount)
+                              .arg(evictedCookies.size() - expiredCount)
+                              .arg(reclaimedBytes);
+
+    emit cookiesEvicted(evictedCookies);
+}
+
+bool LiquidAppCookieStore::compact(qint64* reclaimedBytes)
+{
+    const qint64 diskUsageBeforeCompaction = getDiskUsage();
+
+    QDir().mkpath(QFileInfo(snapshotFilePath).absolutePath());
+
+    // Write the whole set of live cookies into a new snapshot and atomically swap it with the old one
+    QSaveFile snapshotFile(snapshotFilePath);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qDebug().noquote() << QString("Unable to open file %1 in Write mode").arg(snapshotFilePath);
+        return false;
+    }
+
+    QDataStream out(&snapshotFile);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << snapshotMagic << snapshotVersion << (quint32)contents.cookies.size();
+    QHashIterator<QByteArray, QNetworkCookie> i(contents.cookies);
+    while (i.hasNext()) {
+        i.next();
+        writeCookie(out, i.value());
+        out << contents.updateTimes.value(i.key());
+    }
+
+    if (!snapshotFile.commit()) {
+        qDebug().noquote() << QString("Unable to compact cookie store %1").arg(snapshotFilePath);
+        return false;
+    }
+
+    // Everything the journal (and whatever was pending) had is now part of the snapshot.
+    // Should this get interrupted before the journal is gone, replaying it on top of the new snapshot
+    // may bring back cookies that got evicted or removed in the meantime (over-limit and expired ones get purged again on load).
+    QFile::remove(journalFilePath);
+    contents.journalRecordCount = 0;
+    pendingRecords.clear();
+
+    if (reclaimedBytes != Q_NULLPTR) {
+        *reclaimedBytes = diskUsageBeforeCompaction - getDiskUsage();
+    }
+
+    return true;
+}
+
+QByteArray LiquidAppCookieStore::composeRecord(const char op, const QByteArray& cookieId, const QByteArray& rawCookie, const qint64 updateTime)
+{
+    QByteArray record;
+
+    record.append(op);
+    record.append(cookieId.toBase64());
+    if (op == journalOpUpsert) {
+        record.append(' ');
+        record.append(rawCookie.toBase64());
+        record.append(' ');
+        record.append(QByteArray::number(updateTime));
+    }
+    record.append('\n');
+
+    return record;
+}
+
+QList<QNetworkCookie> LiquidAppCookieStore::evictLeastRecentlySet(QList<QByteArray> cookieIds, const int count)
+{
+    QList<QNetworkCookie> evictedCookies;
+    const QHash<QByteArray, qint64>& updateTimes = contents.updateTimes;
+
+    std::sort(cookieIds.begin(), cookieIds.end(), [&updateTimes](const QByteArray& a, const QByteArray& b) {
+        return updateTimes.value(a) < updateTimes.value(b);
+    });
+
+    for (int i = 0; i < count && i < cookieIds.size(); i++) {
+        evictedCookies.append(contents.cookies.take(cookieIds[i]));
+        contents.updateTimes.remove(cookieIds[i]);
+    }
+
+    return evictedCookies;
+}
+
+void LiquidAppCookieStore::flush(void)
+{
+    flushTimer->stop();
+
+    if (pendingRecords.isEmpty()) {
+        return;
+    }
+
+    // Fold the journal into the snapshot instead of appending once it's mostly made of stale records
+    if (isCompactionDue() && compact()) {
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(journalFilePath).absolutePath());
+
+    QFile journalFile(journalFilePath);
+    if (journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        journalFile.write(pendingRecords);
+        journalFile.flush();
+#if defined(Q_OS_UNIX)
+        // Make sure the records make it to the disk even if the system goes down
+        fsync(journalFile.handle());
+#endif
+        journalFile.close();
+
+        pendingRecords.clear();
+    } else {
+        qDebug().noquote() << QString("Unable to open file %1 in Append mode").arg(journalFilePath);
+    }
+}
+
+QByteArray LiquidAppCookieStore::getCookieId(const QNetworkCookie& cookie)
+{
+    // Semicolons can't be part of a cookie's domain, path or name, which makes this ID unambiguous
+    return cookie.domain().toUtf8() + ";" + cookie.path().toUtf8() + ";" + cookie.name();
+}
+
+qint64 LiquidAppCookieStore::getDiskUsage(void)
+{
+    return QFileInfo(snapshotFilePath).size() + QFileInfo(journalFilePath).size();
+}
+
+QString LiquidAppCookieStore::getJournalFilePath(const QString liquidAppName)
+{
+    return Liquid::getCookiesDir().absolutePath() + QDir::separator() + liquidAppName + ".journal";
+}
+
+QString LiquidAppCookieStore::getRegistrableDomain(QString domain)
+{
+    while (domain.startsWith(".")) {
+        domain = domain.right(domain.size() - 1);
+    }
+
+    domain = domain.toLower();
+
+    // IP addresses, hosts without any dots (e.g. "localhost"), etc
+    const QStringList labels = domain.split(".");
+    if (labels.size() < 2 || labels.last().toInt() > 0 || labels.last() == "0") {
+        return domain;
+    }
+
+    // Public suffix (e.g. "co.uk") along with the label that precedes it, e.g. "example.co.uk" for "www.example.co.uk"
+    int publicSuffixLabelCount = 1;
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QUrl url;
+    url.setScheme("http");
+    url.setHost(domain);
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_DEPRECATED
+    const QString publicSuffix = url.topLevelDomain();
+    QT_WARNING_POP
+    if (!publicSuffix.isEmpty()) {
+        publicSuffixLabelCount = publicSuffix.count('.');
+    }
+#else
+    // Qt 6 has no public API for the public suffix list, country-code domains like "co.uk" or "com.au" are the common case
+    static const QStringList secondLevelLabels = QStringList() << "ac" << "co" << "com" << "edu" << "gov" << "net" << "org";
+    if (labels.size() > 2 && labels.last().size() == 2 && secondLevelLabels.contains(labels.at(labels.size() - 2))) {
+        publicSuffixLabelCount = 2;
+    }
+#endif
+
+    if (labels.size() <= publicSuffixLabelCount) {
+        return domain;
+    }
+
+    return QStringList(labels.mid(labels.size() - publicSuffixLabelCount - 1)).join(".");
+}
+
+QString LiquidAppCookieStore::getSnapshotFilePath(const QString liquidAppName)
+{
+    return Liquid::getCookiesDir().absolutePath() + QDir::separator() + liquidAppName + ".cookies";
+}
+
+bool LiquidAppCookieStore::importFromConfig(LiquidSettings* liquidAppConfig)
+{
+    const int cookieCountBeforeImport = contents.cookies.size();
+
+    liquidAppConfig->beginGroup(LQD_CFG_GROUP_NAME_COOKIES);
+    const bool hasLegacyCookies = liquidAppConfig->allKeys().size() > 0;
+    liquidAppConfig->endGroup();
+
+    if (!hasLegacyCookies) {
+        return false;
+    }
+
+    // Legacy cookies stay in the config file until they've made it into the snapshot (see load())
+    readLegacyCookies(liquidAppConfig, contents);
+
+    qDebug().noquote() << QString("Imported %1 cookies from %2").arg(contents.cookies.size() - cookieCountBeforeImport).arg(liquidAppConfig->fileName());
+
+    return true;
+}
+
+bool LiquidAppCookieStore::isCompactionDue(void)
+{
+    return contents.journalRecordCount > LQD_COOKIES_JOURNAL_COMPACTION_THRESHOLD
+        && contents.journalRecordCount > contents.cookies.size();
+}
+
+QList<QNetworkCookie> LiquidAppCookieStore::load(const Contents& contents, LiquidSettings* liquidAppConfig)
+{
+    this->contents = contents;
+
+    const qint64 configFileSizeBeforeImport = QFileInfo(liquidAppConfig->fileName()).size();
+    const bool imported = importFromConfig(liquidAppConfig);
+
+    // Never hand stale cookies back to the web engine
+    int expiredCount = 0;
+    const int evictedCount = purge(&expiredCount).size();
+
+    // Get rid of torn records, dead cookies and redundant history early, before any new records get appended
+    if (imported || contents.isJournalTorn || evictedCount > 0 || isCompactionDue()) {
+        qint64 reclaimedBytes = 0;
+        const bool compacted = compact(&reclaimedBytes);
+
+        if (imported && compacted) {
+            // The cookie store takes over from here, no need to keep parsing these on every run
+            liquidAppConfig->remove(LQD_CFG_GROUP_NAME_COOKIES);
+            liquidAppConfig->sync();
+
+            // Config file without cookies in it is yet to be written
+            LiquidSettings::waitForFlush();
+            reclaimedBytes += configFileSizeBeforeImport - QFileInfo(liquidAppConfig->fileName()).size();
+        } else if (imported) {
+            // Keep them where they are, the import gets retried next time
+            qDebug().noquote() << QString("Unable to move cookies out of %1, leaving them in place").arg(liquidAppConfig->fileName());
+        }
+
+        if (imported || evictedCount > 0) {
+            qDebug().noquote() << QString("Cookie store of Liquid app “%1”: dropped %2 expired and %3 over-limit cookies, reclaimed %4 bytes")
+                                      .arg(liquidAppName)
+                                      .arg(expiredCount)
+                                      .arg(evictedCount - expiredCount)
+                                      .arg(reclaimedBytes);
+        }
+    }
+
+    garbageCollectionTimer->start();
+
+    return this->contents.cookies.values();
+}
+
+QList<QNetworkCookie> LiquidAppCookieStore::purge(int* expiredCount)
+{
+    QList<QNetworkCookie> evictedCookies;
+
+    // Expired cookies go first
+    {
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        QList<QByteArray> expiredCookieIds;
+
+        QHashIterator<QByteArray, QNetworkCookie> i(contents.cookies);
+        while (i.hasNext()) {
+            i.next();
+            if (!i.value().isSessionCookie() && i.value().expirationDate() <= now) {
+                expiredCookieIds.append(i.key());
+            }
+        }
+
+        foreach (const QByteArray cookieId, expiredCookieIds) {
+            evictedCookies.append(contents.cookies.take(cookieId));
+            contents.updateTimes.remove(cookieId);
+        }
+
+        *expiredCount = evictedCookies.size();
+    }
+
+    // Then the least recently set ones from domains that have way too many cookies,
+    // subdomains count towards the domain they belong to (same as Chromium does it)
+    {
+        QHash<QString, QList<QByteArray>> cookieIdsByDomain;
+
+        QHashIterator<QByteArray, QNetworkCookie> i(contents.cookies);
+        while (i.hasNext()) {
+            i.next();
+            cookieIdsByDomain[getRegistrableDomain(i.value().domain())].append(i.key());
+        }
+
+        foreach (const QList<QByteArray> domainCookieIds, cookieIdsByDomain) {
+            if (domainCookieIds.size() > LQD_COOKIES_MAX_PER_DOMAIN) {
+                evictedCookies.append(evictLeastRecentlySet(domainCookieIds,
+                                      domainCookieIds.size() - (LQD_COOKIES_MAX_PER_DOMAIN - LQD_COOKIES_PURGE_PER_DOMAIN)));
+            }
+        }
+    }
+
+    // And finally the least recently set ones overall
+    if (contents.cookies.size() > LQD_COOKIES_MAX_TOTAL) {
+        evictedCookies.append(evictLeastRecentlySet(contents.cookies.keys(),
+                              contents.cookies.size() - (LQD_COOKIES_MAX_TOTAL - LQD_COOKIES_PURGE_TOTAL)));
+    }
+
+    return evictedCookies;
+}
+
+QFuture<LiquidAppCookieStore::Contents> LiquidAppCookieStore::read(void)
+{
+    return QtConcurrent::run(&LiquidAppCookieStore::readFromDisk, snapshotFilePath, journalFilePath);
+}
+
+QNetworkCookie LiquidAppCookieStore::readCookie(QDataStream& in)
+{
+    QByteArray name;
+    QByteArray value;
+    QString domain;
+    QString path;
+    qint64 expirationDate;
+    quint8 flags;
+    quint8 sameSitePolicy;
+
+    in >> name >> value >> domain >> path >> expirationDate >> flags >> sameSitePolicy;
+
+    QNetworkCookie cookie(name, value);
+    cookie.setDomain(domain);
+    cookie.setPath(path);
+    if (expirationDate >= 0) {
+        cookie.setExpirationDate(QDateTime::fromMSecsSinceEpoch(expirationDate, Qt::UTC));
+    }
+    cookie.setSecure(flags & 0x01);
+    cookie.setHttpOnly(flags & 0x02);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 1, 0)
+    cookie.setSameSitePolicy(static_cast<QNetworkCookie::SameSite>(sameSitePolicy));
+#else
+    Q_UNUSED(sameSitePolicy);
+#endif
+
+    return cookie;
+}
+
+QList<QNetworkCookie> LiquidAppCookieStore::readCookies(const QString liquidAppName, LiquidSettings* liquidAppConfig)
+{
+    Contents contents = readFromDisk(getSnapshotFilePath(liquidAppName), getJournalFilePath(liquidAppName));
+
+    readLegacyCookies(liquidAppConfig, contents);
+
+    return contents.cookies.values();
+}
+
+LiquidAppCookieStore::Contents LiquidAppCookieStore::readFromDisk(const QString snapshotFilePath, const QString journalFilePath)
+{
+    Contents contents;
+
+    readSnapshot(snapshotFilePath, contents);
+    readJournal(journalFilePath, contents);
+
+    return contents;
+}
+
+void LiquidAppCookieStore::readJournal(const QString filePath, Contents& contents)
+{
+    QFile journalFile(filePath);
+    if (!journalFile.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QByteArray journal = journalFile.readAll();
+    journalFile.close();
+
+    int pos = 0;
+    while (pos < journal.size()) {
+        const int eol = journal.indexOf('\n', pos);
+
+        if (eol < 0) {
+            // The last write got interrupted half-way through
+            contents.isJournalTorn = true;
+            break;
+        }
+
+        const QByteArray record = journal.mid(pos, eol - pos);
+        pos = eol + 1;
+
+        if (record.size() < 2) {
+            continue;
+        }
+
+        switch (record.at(0)) {
+            case journalOpUpsert:
+                {
+                    const QList<QByteArray> fields = record.mid(1).split(' ');
+                    if (fields.size() < 2) {
+                        continue;
+                    }
+                    const QList<QNetworkCookie> parsedCookies = QNetworkCookie::parseCookies(QByteArray::fromBase64(fields[1]));
+                    if (parsedCookies.size() > 0) {
+                        const QByteArray cookieId = QByteArray::fromBase64(fields[0]);
+                        contents.cookies.insert(cookieId, parsedCookies[0]);
+                        contents.updateTimes.insert(cookieId, (fields.size() > 2) ? fields[2].toLongLong() : 0);
+                    }
+                }
+                break;
+
+            case journalOpRemove:
+                {
+                    const QByteArray cookieId = QByteArray::fromBase64(record.mid(1));
+                    contents.cookies.remove(cookieId);
+                    contents.updateTimes.remove(cookieId);
+                }
+                break;
+
+            default:
+                continue;
+        }
+
+        contents.journalRecordCount++;
+    }
+}
+
+void LiquidAppCookieStore::readLegacyCookies(LiquidSettings* liquidAppConfig, Contents& contents)
+{
+    liquidAppConfig->beginGroup(LQD_CFG_GROUP_NAME_COOKIES);
+    foreach (QString cookieKey, liquidAppConfig->allKeys()) {
+        const QByteArray rawCookie = liquidAppConfig->value(cookieKey).toByteArray();
+        const QList<QNetworkCookie> parsedCookies = QNetworkCookie::parseCookies(rawCookie);
+        if (parsedCookies.size() > 0) {
+            const QByteArray cookieId = getCookieId(parsedCookies[0]);
+            // Whatever is in the cookie store is newer than what's left in the config file
+            if (!contents.cookies.contains(cookieId)) {
+                contents.cookies.insert(cookieId, parsedCookies[0]);
+                contents.updateTimes.insert(cookieId, 0);
+            }
+        }
+    }
+    liquidAppConfig->endGroup();
+}
+
+bool LiquidAppCookieStore::readSnapshot(const QString filePath, Contents& contents)
+{
+    QFile snapshotFile(filePath);
+    if (!snapshotFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&snapshotFile);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic;
+    quint16 version;
+    quint32 count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != snapshotMagic || version < 1 || version > snapshotVersion) {
+        qDebug().noquote() << QString("Ignoring unrecognized cookie snapshot %1").arg(filePath);
+        return false;
+    }
+
+    contents.cookies.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        const QNetworkCookie cookie = readCookie(in);
+        qint64 updateTime = 0;
+        if (version >= 2) {
+            in >> updateTime;
+        }
+        const QByteArray cookieId = getCookieId(cookie);
+        contents.cookies.insert(cookieId, cookie);
+        contents.updateTimes.insert(cookieId, updateTime);
+    }
+
+    return in.status() == QDataStream::Ok;
+}
+
+void LiquidAppCookieStore::removeCookie(const QNetworkCookie& cookie)
+{
+    const QByteArray cookieId = getCookieId(cookie);
+
+    if (contents.cookies.remove(cookieId) > 0) {
+        contents.updateTimes.remove(cookieId);
+        appendRecord(composeRecord(journalOpRemove, cookieId));
+    }
+}
+
+void LiquidAppCookieStore::upsertCookie(const QNetworkCookie& cookie)
+{
+    const QByteArray cookieId = getCookieId(cookie);
+
+    // Cookies handed back by the web engine after being restored are already on disk
+    QHash<QByteArray, QNetworkCookie>::const_iterator existingCookie = contents.cookies.constFind(cookieId);
+    if (existingCookie != contents.cookies.constEnd() && *existingCookie == cookie) {
+        return;
+    }
+
+    const qint64 updateTime = QDateTime::currentMSecsSinceEpoch();
+
+    contents.cookies.insert(cookieId, cookie);
+    contents.updateTimes.insert(cookieId, updateTime);
+    appendRecord(composeRecord(journalOpUpsert, cookieId, cookie.toRawForm(QNetworkCookie::Full), updateTime));
+}
+
+void LiquidAppCookieStore::writeCookie(QDataStream& out, const QNetworkCookie& cookie)
+{
+    quint8 flags = 0;
+    quint8 sameSitePolicy = 0;
+
+    if (cookie.isSecure()) {
+        flags |= 0x01;
+    }
+    if (cookie.isHttpOnly()) {
+        flags |= 0x02;
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 1, 0)
+    sameSitePolicy = static_cast<quint8>(cookie.sameSitePolicy());
+#endif
+
+    out << cookie.name()
+        << cookie.value()
+        << cookie.domain()
+        << cookie.path()
+        << (qint64)((cookie.isSessionCookie()) ? -1 : cookie.expirationDate().toMSecsSinceEpoch())
+        << flags
+        << sameSitePolicy;
+}
@@ -0,0 +1,186 @@
+#include <QDateTime>
+#include <QPointer>
+#include <QWebEngineScript>
+
+#if defined(Q_OS_UNIX)
+#include <signal.h>
+#endif
+
+#include "liquid.hpp"
+#include "liquidapphealthwatchdog.hpp"
+#include "liquidappwebpage.hpp"
+#include "lqd.h"
+
+/*
+ * Left on its own, a Liquid app whose renderer process crashed shows nothing but a blank page,
+ * and one whose renderer hung simply stops responding.
+ *
+ * The watchdog loads the last URL again as soon as the renderer is gone,
+ * and keeps checking whether the renderer still responds by having it run a tiny script every few seconds.
+ * Running it within the application's own world works even with JavaScript disabled for the web page.
+ * A renderer that misses a couple of heartbeats in a row is considered hung, and gets killed (which then gets it brought back).
+ * That goes for pages which are still loading too, a script stuck in an endless loop keeps the load from ever finishing.
+ * Renderers are expected to be unresponsive while they wait on a dialog (alert, confirm, prompt, sign-in),
+ * and nobody would notice a hidden page hanging anyway, heartbeats are paused in either case.
+ *
+ * Crashes and hangs get appended to a CSV file within the logs directory.
+ */
+LiquidAppHealthWatchdog::LiquidAppHealthWatchdog(const QString liquidAppName, LiquidAppWebPage* page, QObject* parent) : QObject(parent)
+{
+    this->liquidAppName = liquidAppName;
+    this->page = page;
+
+    connect(page, &QWebEnginePage::loadStarted, this, &LiquidAppHealthWatchdog::onNavigation);
+    connect(page, &QWebEnginePage::renderProcessTerminated, this, &LiquidAppHealthWatchdog::onRenderProcessTerminated);
+    connect(page, &QWebEnginePage::urlChanged, this, [this](const QUrl url) {
+        if (url.isValid() && !url.isEmpty()) {
+            lastUrl = url;
+        }
+
+        onNavigation();
+    });
+
+    heartbeatTimer = new QTimer(this);
+    heartbeatTimer->setInterval(LQD_WATCHDOG_HEALTH_INTERVAL);
+    connect(heartbeatTimer, &QTimer::timeout, this, &LiquidAppHealthWatchdog::sendHeartbeat);
+    heartbeatTimer->start();
+}
+
+bool LiquidAppHealthWatchdog::isPaused(void) const
+{
+    if (page->isDialogOpen()) {
+        return true;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // Frozen and discarded pages aren't supposed to respond
+    if (!page->isVisible() || page->lifecycleState() != QWebEnginePage::LifecycleState::Active) {
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+void LiquidAppHealthWatchdog::log(const QString event)
+{
+    qint64 renderProcessId = -1;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    renderProcessId = page->renderProcessPid();
+#endif
+
+    Liquid::appendLogRecord(LQD_WATCHDOG_HEALTH_LOG_NAME,
+                            QStringList() << "Time" << "LiquidApp" << "RenderProcessID" << "URL" << "Event",
+                            QStringList() << QDateTime::currentDateTimeUtc().toString(Qt::ISODate)
+                                          << liquidAppName
+                                          << QString::number(renderProcessId)
+                                          << lastUrl.toString()
+                                          << event);
+}
+
+void LiquidAppHealthWatchdog::onNavigation(void)
+{
+    // Heartbeats may get dropped along with the document they were sent to, the next one goes to the new document
+    heartbeatIsPending = false;
+    missedHeartbeatCount = 0;
+}
+
+void LiquidAppHealthWatchdog::onRenderProcessTerminated(const QWebEnginePage::RenderProcessTerminationStatus terminationStatus, const int exitCode)
+{
+    heartbeatIsPending = false;
+    missedHeartbeatCount = 0;
+
+    if (rendererIsBeingKilled) {
+        rendererIsBeingKilled = false;
+    } else {
+        // Renderers also go away when pages get discarded, nothing to bring back then
+        if (terminationStatus == QWebEnginePage::NormalTerminationStatus) {
+            return;
+        }
+
+        log(QString("crash (exit code %1)").arg(exitCode));
+        emit crashed();
+    }
+
+    if (lastRecoveryElapsedTimer.isValid() && lastRecoveryElapsedTimer.elapsed() < LQD_WATCHDOG_HEALTH_MAX_DELAY) {
+        recoveryDelay = qBound(LQD_WATCHDOG_HEALTH_INTERVAL, recoveryDelay * 2, LQD_WATCHDOG_HEALTH_MAX_DELAY);
+    } else {
+        recoveryDelay = 0;
+    }
+
+    // Not from within the signal that reports renderer's termination
+    QTimer::singleShot(recoveryDelay, this, &LiquidAppHealthWatchdog::recover);
+}
+
+void LiquidAppHealthWatchdog::recover(void)
+{
+    lastRecoveryElapsedTimer.start();
+
+    page->load((lastUrl.isValid()) ? lastUrl : page->requestedUrl());
+}
+
+void LiquidAppHealthWatchdog::sendHeartbeat(void)
+{
+    // Whatever was awaited before pausing doesn't count, start over once resumed
+    if (isPaused()) {
+        heartbeatIsPending = false;
+        missedHeartbeatCount = 0;
+        return;
+    }
+
+    if (heartbeatIsPending) {
+        if (heartbeatElapsedTimer.elapsed() < LQD_WATCHDOG_HEALTH_TIMEOUT) {
+            return;
+        }
+
+        // Long-running scripts may keep the renderer busy for a while, give it a few more chances
+        missedHeartbeatCount++;
+        if (missedHeartbeatCount < LQD_WATCHDOG_HEALTH_MAX_MISSED) {
+            heartbeatElapsedTimer.start();
+            return;
+        }
+
+        heartbeatIsPending = false;
+        missedHeartbeatCount = 0;
+
+        qint64 renderProcessId = -1;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        renderProcessId = page->renderProcessPid();
+#endif
+
+        if (renderProcessId <= 0) {
+            return;
+        }
+
+        log("hang");
+        emit hung();
+
+#if defined(Q_OS_UNIX)
+        // Gets reported as renderer's termination, which is what brings the page back
+        rendererIsBeingKilled = true;
+        kill(renderProcessId, SIGKILL);
+#else
+        page->load((lastUrl.isValid()) ? lastUrl : page->requestedUrl());
+#endif
+
+        return;
+    }
+
+    // Nothing to ask before anything gets loaded
+    if (page->url().isEmpty()) {
+        return;
+    }
+
+    heartbeatIsPending = true;
+    heartbeatElapsedTimer.start();
+
+    const quint64 sentHeartbeatId = ++heartbeatId;
+    QPointer<LiquidAppHealthWatchdog> watchdog(this);
+    page->runJavaScript("0", QWebEngineScript::ApplicationWorld, [watchdog, sentHeartbeatId](const QVariant&) {
+        // Answers to heartbeats that are no longer awaited don't count
+        if (watchdog && watchdog->heartbeatId == sentHeartbeatId) {
+            watchdog->heartbeatIsPending = false;
+            watchdog->missedHeartbeatCount = 0;
+        }
+    });
+}
@@ -0,0 +1,225 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QTimer>
+
+#include "liquid.hpp"
+#include "liquidapphost.hpp"
+#include "liquidsettings.hpp"
+#include "lqd.h"
+
+/*
+ * The app host is an opt-in resident process (liquid --host) which runs Liquid apps
+ * as windows of its own, instead of every one of them starting a separate process.
+ * All of them share one web engine (and its browser, GPU, and utility processes),
+ * yet every Liquid app still gets its own off-the-record profile, same as when running on its own,
+ * which keeps cookies, cache, and storage of separate Liquid apps from ever crossing paths.
+ *
+ * Network proxy settings and engine flags apply to the whole process, so Liquid apps that use a proxy
+ * or have engine settings of their own get declined, leaving whoever asked to run them in a separate process as usual.
+ *
+ * Requests are single lines sent over a local socket:
+ *   run <Liquid app name>[<TAB><URL>]  (replied to with "ok" or "declined")
+ *   stats                              (replied to with the host's process ID and the number of Liquid apps it runs)
+ */
+static const QByteArray requestRun("run ");
+static const QByteArray requestStatistics("stats");
+static const QByteArray replyOk("ok");
+static const QByteArray replyDeclined("declined");
+
+LiquidAppHost::LiquidAppHost(QObject* parent) : QObject(parent)
+{
+    server = new QLocalServer(this);
+    // Don't let other users run anything within this host
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &LiquidAppHost::onNewConnection);
+}
+
+LiquidAppHost::~LiquidAppHost(void)
+{
+    foreach (LiquidAppWindow* liquidAppWindow, liquidAppWindows) {
+        liquidAppWindow->close();
+        delete liquidAppWindow;
+    }
+
+    qDeleteAll(instanceServers);
+}
+
+QString LiquidAppHost::getServerName(void)
+{
+    return Liquid::getUserName() + "_Liquid_host";
+}
+
+void LiquidAppHost::handleRequest(QLocalSocket* socket, const QByteArray& request)
+{
+    if (request.startsWith(requestRun)) {
+        const QList<QByteArray> arguments = request.mid(requestRun.size()).split('\t');
+        const QUrl url = (arguments.size() > 1) ? QUrl::fromEncoded(arguments.at(1)) : QUrl();
+        const bool isLaunched = launch(QString::fromUtf8(arguments.at(0)), url);
+        socket->write(((isLaunched) ? replyOk : replyDeclined) + "\n");
+        socket->flush();
+    } else if (request == requestStatistics) {
+        socket->write(QString("%1 %2\n").arg(QCoreApplication::applicationPid()).arg(liquidAppWindows.size()).toUtf8());
+        socket->flush();
+    }
+}
+
+bool LiquidAppHost::launch(const QString liquidAppName, const QUrl url)
+{
+    // Bring it up if it's already running within this host
+    if (liquidAppWindows.contains(liquidAppName)) {
+        liquidAppWindows.value(liquidAppName)->activate(url);
+        return true;
+    }
+
+    {
+        const LiquidSettings* liquidAppConfig = LiquidSettings::forLiquidApp(liquidAppName);
+
+        // Nothing to run, leave it up to the caller to offer creating it
+        if (!liquidAppConfig->contains(LQD_CFG_KEY_NAME_URL)) {
+            return false;
+        }
+
+        // It would affect every other Liquid app within this host
+        if (liquidAppConfig->value(LQD_CFG_KEY_NAME_USE_PROXY, false).toBool()) {
+            return false;
+        }
+    }
+
+    // Same goes for engine settings, which get applied as the process starts up
+    if (Liquid::getChromiumFlags(liquidAppName) != Liquid::getChromiumFlags()) {
+        return false;
+    }
+
+    // About to be shown already, the URL gets opened once the window is there
+    if (instanceServers.contains(liquidAppName)) {
+        if (url.isValid()) {
+            pendingUrls[liquidAppName].append(url);
+        }
+
+        return true;
+    }
+
+    // Already running elsewhere, there's nothing for the caller to do either
+    if (LiquidInstanceServer::requestActivation(liquidAppName, url)) {
+        return true;
+    }
+
+    // Same as Liquid apps running on their own, let later attempts to run it bring this one up
+    LiquidInstanceServer* instanceServer = new LiquidInstanceServer(liquidAppName, this);
+    if (!instanceServer->listen()) {
+        delete instanceServer;
+        return true;
+    }
+
+    instanceServers.insert(liquidAppName, instanceServer);
+
+    // Other processes may ask for it to be brought up before its window exists, too
+    connect(instanceServer, &LiquidInstanceServer::activationRequested, this, [this, liquidAppName](const QUrl url) {
+        if (!liquidAppWindows.contains(liquidAppName) && url.isValid()) {
+            pendingUrls[liquidAppName].append(url);
+        }
+    });
+
+    // Let the caller know right away, setting up a Liquid app window takes a moment
+    QTimer::singleShot(0, this, [this, liquidAppName, url, instanceServer]() {
+        // Liquid app windows keep a pointer to their name, so it has to outlive them
+        QString* liquidAppNameCopy = new QString(liquidAppName);
+        LiquidAppWindow* liquidAppWindow = new LiquidAppWindow(liquidAppNameCopy);
+
+        liquidAppWindows.insert(liquidAppName, liquidAppWindow);
+
+        connect(instanceServer, &LiquidInstanceServer::activationRequested, liquidAppWindow, &LiquidAppWindow::activate);
+        liquidAppWindow->activate(url);
+
+        foreach (const QUrl pendingUrl, pendingUrls.take(liquidAppName)) {
+            liquidAppWindow->activate(pendingUrl);
+        }
+
+        connect(liquidAppWindow, &QObject::destroyed, this, [this, liquidAppName, liquidAppNameCopy]() {
+            liquidAppWindows.remove(liquidAppName);
+            delete instanceServers.take(liquidAppName);
+            delete liquidAppNameCopy;
+        });
+    });
+
+    return true;
+}
+
+bool LiquidAppHost::listen(void)
+{
+    bool isAlreadyRunning = false;
+
+    if (!Liquid::listenOnLocalSocket(server, getServerName(), &isAlreadyRunning)) {
+        if (isAlreadyRunning) {
+            qDebug().noquote() << QString("Liquid app host is already running");
+        } else {
+            qDebug().noquote() << QString("Unable to start Liquid app host: %1").arg(server->errorString());
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void LiquidAppHost::onNewConnection(void)
+{
+    while (server->hasPendingConnections()) {
+        QLocalSocket* socket = server->nextPendingConnection();
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            while (socket->canReadLine()) {
+                handleRequest(socket, socket->readLine().trimmed());
+            }
+        });
+
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+bool LiquidAppHost::requestLaunch(const QString liquidAppName, const QUrl url)
+{
+    QByteArray request = requestRun + liquidAppName.toUtf8();
+    if (url.isValid()) {
+        request += "\t" + url.toEncoded();
+    }
+
+    return sendRequest(request) == replyOk;
+}
+
+bool LiquidAppHost::requestStats(qint64* hostProcessId, int* liquidAppCount)
+{
+    const QList<QByteArray> reply = sendRequest(requestStatistics).split(' ');
+
+    if (reply.size() != 2) {
+        return false;
+    }
+
+    *hostProcessId = reply.at(0).toLongLong();
+    *liquidAppCount = reply.at(1).toInt();
+
+    return true;
+}
+
+QByteArray LiquidAppHost::sendRequest(const QByteArray& request)
+{
+    QLocalSocket socket;
+
+    socket.connectToServer(getServerName());
+    if (!socket.waitForConnected(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return QByteArray();
+    }
+
+    socket.write(request + "\n");
+    if (!socket.waitForBytesWritten(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return QByteArray();
+    }
+
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(LQD_LAUNCHER_REPLY_TIMEOUT)) {
+            return QByteArray();
+        }
+    }
+
+    return socket.readLine().trimmed();
+}
@@ -0,0 +1,157 @@
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+#include "liquid.hpp"
+#include "liquidappiconcache.hpp"
+#include "liquidappindex.hpp"
+#include "lqd.h"
+
+/*
+ * Icons are stored in the icon cache directory as <hash>-<size>.png,
+ * where <hash> is the SHA-256 of the original icon's PNG data.
+ * Liquid apps' config files only reference icons by that hash,
+ * which also makes Liquid apps with identical icons share the same files.
+ */
+static const int iconSizes[] = { 16, 32, 64, 128 }; // The largest one goes last
+static const int iconSizesCount = sizeof(iconSizes) / sizeof(iconSizes[0]);
+
+static const QString dataUrlPrefix("data:image/png;base64,");
+
+QIcon LiquidAppIconCache::getIcon(const QString iconReference)
+{
+    QIcon icon;
+
+    if (iconReference.isEmpty()) {
+        return icon;
+    }
+
+    // Config files written by older versions have icons embedded in them
+    if (isDataUrl(iconReference)) {
+        QPixmap pixmap;
+        pixmap.loadFromData(QByteArray::fromBase64(iconReference.mid(dataUrlPrefix.size()).toLatin1()), "PNG");
+        return QIcon(pixmap);
+    }
+
+    // The largest size gets written last, no point in going any further without it
+    if (!QFile::exists(getIconFilePath(iconReference, iconSizes[iconSizesCount - 1]))) {
+        return icon;
+    }
+
+    // Files get read only once a pixmap of that particular size is requested
+    for (int i = 0; i < iconSizesCount; i++) {
+        icon.addFile(getIconFilePath(iconReference, iconSizes[i]), QSize(iconSizes[i], iconSizes[i]));
+    }
+
+    return icon;
+}
+
+QString LiquidAppIconCache::getIconFilePath(const QString iconHash, const int size)
+{
+    return Liquid::getIconsDir().absoluteFilePath(QString("%1-%2.png").arg(iconHash).arg(size));
+}
+
+bool LiquidAppIconCache::isDataUrl(const QString iconReference)
+{
+    return iconReference.startsWith(dataUrlPrefix);
+}
+
+void LiquidAppIconCache::removeIcon(const QString iconHash)
+{
+    if (iconHash.isEmpty() || isDataUrl(iconHash)) {
+        return;
+    }
+
+    for (int i = 0; i < iconSizesCount; i++) {
+        QFile::remove(getIconFilePath(iconHash, iconSizes[i]));
+    }
+}
+
+void LiquidAppIconCache::removeIconUnlessInUse(const QString iconHash, const QString exceptLiquidAppName)
+{
+    if (iconHash.isEmpty() || isDataUrl(iconHash)) {
+        return;
+    }
+
+    // Liquid apps with identical icons share the same files
+    LiquidAppIndex liquidAppIndex;
+    liquidAppIndex.refresh();
+    foreach (const LiquidAppIndex::Entry liquidAppIndexEntry, liquidAppIndex.getEntries()) {
+        if (liquidAppIndexEntry.name != exceptLiquidAppName && liquidAppIndexEntry.icon == iconHash) {
+            return;
+        }
+    }
+
+    removeIcon(iconHash);
+}
+
+QString LiquidAppIconCache::storeDataUrl(const QString dataUrl)
+{
+    QPixmap pixmap;
+
+    if (!isDataUrl(dataUrl) || !pixmap.loadFromData(QByteArray::fromBase64(dataUrl.mid(dataUrlPrefix.size()).toLatin1()), "PNG")) {
+        return QString();
+    }
+
+    return storePixmap(pixmap);
+}
+
+QString LiquidAppIconCache::storeIcon(const QIcon& icon)
+{
+    if (icon.isNull()) {
+        return QString();
+    }
+
+    // Pick the largest size the icon is available in
+    QSize largestSize(iconSizes[iconSizesCount - 1], iconSizes[iconSizesCount - 1]);
+    const QList<QSize> availableSizes = icon.availableSizes();
+    if (availableSizes.size() > 0) {
+        largestSize = availableSizes[0];
+        foreach (const QSize size, availableSizes) {
+            if (size.width() * size.height() > largestSize.width() * largestSize.height()) {
+                largestSize = size;
+            }
+        }
+    }
+
+    return storePixmap(icon.pixmap(largestSize));
+}
+
+QString LiquidAppIconCache::storePixmap(const QPixmap& pixmap)
+{
+    if (pixmap.isNull()) {
+        return QString();
+    }
+
+    QByteArray pngData;
+    QBuffer buffer(&pngData);
+    buffer.open(QIODevice::WriteOnly);
+    pixmap.save(&buffer, "PNG");
+    buffer.close();
+
+    const QString iconHash = QCryptographicHash::hash(pngData, QCryptographicHash::Sha256).toHex();
+
+    // Identical icons get stored only once
+    if (QFile::exists(getIconFilePath(iconHash, iconSizes[iconSizesCount - 1]))) {
+        return iconHash;
+    }
+
+    QDir().mkpath(Liquid::getIconsDir().absolutePath());
+
+    for (int i = 0; i < iconSizesCount; i++) {
+        const QString iconFilePath = getIconFilePath(iconHash, iconSizes[i]);
+        QSaveFile iconFile(iconFilePath);
+
+        if (!iconFile.open(QIODevice::WriteOnly)
+            || !pixmap.scaled(iconSizes[i], iconSizes[i], Qt::KeepAspectRatio, Qt::SmoothTransformation).save(&iconFile, "PNG")
+            || !iconFile.commit()
+        ) {
+            qDebug().noquote() << QString("Unable to write icon file %1").arg(iconFilePath);
+            return QString();
+        }
+    }
+
+    return iconHash;
+}
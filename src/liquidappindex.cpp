@@ -0,0 +1,162 @@
+#include <QDebug>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+#include <QSettings>
+
+#include "liquid.hpp"
+#include "liquidappindex.hpp"
+#include "lqd.h"
+
+/*
+ * The index is a binary file that caches a few values from every Liquid app's config file,
+ * so that the launcher doesn't have to parse each and every one of them whenever it gets opened.
+ * An entry gets re-read from the config file only once its modification time or size change.
+ */
+static const quint32 indexMagic = 0x4c514958; // "LQIX"
+static const quint16 indexVersion = 1;
+
+LiquidAppIndex::LiquidAppIndex(QObject* parent) : QObject(parent)
+{
+    indexFilePath = getIndexFilePath();
+
+    readFromDisk();
+}
+
+QList<LiquidAppIndex::Entry> LiquidAppIndex::getEntries(void)
+{
+    QList<Entry> orderedEntries;
+
+    foreach (const QString liquidAppName, liquidAppNames) {
+        orderedEntries.append(entries.value(liquidAppName));
+    }
+
+    return orderedEntries;
+}
+
+QString LiquidAppIndex::getIndexFilePath(void)
+{
+    return Liquid::getConfigDir().absolutePath() + QDir::separator() + LQD_APPS_INDEX_NAME;
+}
+
+bool LiquidAppIndex::readFromDisk(void)
+{
+    QFile indexFile(indexFilePath);
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&indexFile);
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic;
+    quint16 version;
+    quint32 count;
+    in >> magic >> version >> count;
+    if (in.status() != QDataStream::Ok || magic != indexMagic || version != indexVersion) {
+        qDebug().noquote() << QString("Ignoring unrecognized app index %1").arg(indexFilePath);
+        return false;
+    }
+
+    entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        const Entry entry = readEntry(in);
+        liquidAppNames.append(entry.name);
+        entries.insert(entry.name, entry);
+    }
+
+    // A truncated index is no good, everything will simply get re-indexed
+    if (in.status() != QDataStream::Ok) {
+        liquidAppNames.clear();
+        entries.clear();
+        return false;
+    }
+
+    return true;
+}
+
+LiquidAppIndex::Entry LiquidAppIndex::readEntry(const QFileInfo& liquidAppConfigFileInfo)
+{
+    Entry entry;
+
+    entry.name = liquidAppConfigFileInfo.completeBaseName();
+    entry.modificationTime = liquidAppConfigFileInfo.lastModified().toMSecsSinceEpoch();
+    entry.size = liquidAppConfigFileInfo.size();
+
+    const QSettings liquidAppConfig(liquidAppConfigFileInfo.absoluteFilePath(), QSettings::IniFormat);
+    entry.title = liquidAppConfig.value(LQD_CFG_KEY_NAME_TITLE).toString();
+    entry.url = liquidAppConfig.value(LQD_CFG_KEY_NAME_URL).toString();
+    entry.icon = liquidAppConfig.value(LQD_CFG_KEY_NAME_ICON).toString();
+
+    return entry;
+}
+
+LiquidAppIndex::Entry LiquidAppIndex::readEntry(QDataStream& in)
+{
+    Entry entry;
+
+    in >> entry.name >> entry.title >> entry.url >> entry.icon >> entry.modificationTime >> entry.size;
+
+    return entry;
+}
+
+void LiquidAppIndex::refresh(void)
+{
+    bool isDirty = false;
+    QStringList refreshedLiquidAppNames;
+    QHash<QString, Entry> refreshedEntries;
+
+    // Same listing as Liquid::getLiquidAppsList(), minus having to stat every file once again
+    foreach (const QFileInfo liquidAppFileInfo, Liquid::getLiquidAppsFileList()) {
+        const QString liquidAppName = liquidAppFileInfo.completeBaseName();
+        QHash<QString, Entry>::const_iterator existingEntry = entries.constFind(liquidAppName);
+
+        // Only parse config files which have changed since they were last indexed
+        if (existingEntry != entries.constEnd()
+            && existingEntry->modificationTime == liquidAppFileInfo.lastModified().toMSecsSinceEpoch()
+            && existingEntry->size == liquidAppFileInfo.size()
+        ) {
+            refreshedEntries.insert(liquidAppName, *existingEntry);
+        } else {
+            refreshedEntries.insert(liquidAppName, readEntry(liquidAppFileInfo));
+            isDirty = true;
+        }
+
+        refreshedLiquidAppNames.append(liquidAppName);
+    }
+
+    // Some Liquid apps are gone
+    if (refreshedEntries.size() != entries.size()) {
+        isDirty = true;
+    }
+
+    liquidAppNames = refreshedLiquidAppNames;
+    entries = refreshedEntries;
+
+    if (isDirty) {
+        writeToDisk();
+    }
+}
+
+void LiquidAppIndex::writeEntry(QDataStream& out, const Entry& entry)
+{
+    out << entry.name << entry.title << entry.url << entry.icon << entry.modificationTime << entry.size;
+}
+
+bool LiquidAppIndex::writeToDisk(void)
+{
+    QSaveFile indexFile(indexFilePath);
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        qDebug().noquote() << QString("Unable to open file %1 in Write mode").arg(indexFilePath);
+        return false;
+    }
+
+    QDataStream out(&indexFile);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << indexMagic << indexVersion << (quint32)liquidAppNames.size();
+    foreach (const QString liquidAppName, liquidAppNames) {
+        writeEntry(out, entries.value(liquidAppName));
+    }
+
+    return indexFile.commit();
+}
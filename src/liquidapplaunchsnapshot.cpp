@@ -0,0 +1,199 @@
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSettings>
+
+#include "liquid.hpp"
+#include "liquidapplaunchsnapshot.hpp"
+#include "liquidsettings.hpp"
+#include "lqd.h"
+
+/*
+ * Everything Liquid app needs out of its settings file in order to get started, in a form that takes no effort to get back:
+ * values that are already parsed out of INI and scripts that are already put together, all in one binary file
+ * that gets mapped into memory and read in one go.
+ *
+ * Snapshots get made anew right after settings files get written (see LiquidSettings), and are only trusted
+ * when made out of the settings file as it is now (same modification time and size);
+ * otherwise the settings file gets parsed, same as it would be without any snapshot.
+ */
+static const quint32 snapshotMagic = 0x4c514c53; // "LQLS"
+static const quint16 snapshotVersion = 3; // 3 has additional CSS moved after page's own stylesheets once <head> is complete
+
+// Liquid app name -> snapshot, it's needed more than once (web engine flags, settings, window)
+static QHash<QString, LiquidAppLaunchSnapshot> launchSnapshots;
+
+LiquidAppLaunchSnapshot LiquidAppLaunchSnapshot::build(const QString liquidAppName)
+{
+    LiquidAppLaunchSnapshot snapshot;
+    const QString settingsFilePath = LiquidSettings::getLiquidAppFilePath(liquidAppName);
+
+    // Looked at before parsing, should the file change in the meantime this snapshot won't match it
+    const QFileInfo settingsFileInfo(settingsFilePath);
+    if (!settingsFileInfo.exists()) {
+        return snapshot;
+    }
+    snapshot.settingsFileModificationTime = settingsFileInfo.lastModified();
+    snapshot.settingsFileSize = settingsFileInfo.size();
+
+    const QSettings settings(settingsFilePath, QSettings::IniFormat);
+    foreach (const QString key, settings.allKeys()) {
+        snapshot.values.insert(key, settings.value(key));
+    }
+
+    if (snapshot.values.contains(LQD_CFG_KEY_NAME_ADDITIONAL_CSS)) {
+        snapshot.additionalCssScriptSource = getAdditionalCssScriptSource(snapshot.values.value(LQD_CFG_KEY_NAME_ADDITIONAL_CSS).toString());
+    }
+
+    if (snapshot.values.contains(LQD_CFG_KEY_NAME_ADDITIONAL_JS)) {
+        snapshot.additionalJsScriptSource = snapshot.values.value(LQD_CFG_KEY_NAME_ADDITIONAL_JS).toString();
+    }
+
+    snapshot.isFromSettingsFile = true;
+
+    return snapshot;
+}
+
+QString LiquidAppLaunchSnapshot::getAdditionalCssScriptSource(QString additionalCss)
+{
+    // Gets injected upon document's creation, when there's no <head> yet;
+    // inserted right away to have the page styled from the start, then moved to the end of <head>
+    // once it's complete, for user's CSS to come after (and win ties with) page's own stylesheets
+    return QString("(()=>{"\
+                       "const styleEl = document.createElement('style');"\
+                       "const cssTextNode = document.createTextNode('%1');"\
+                       "styleEl.appendChild(cssTextNode);"\
+                       "const insertStyleEl = () => (document.head || document.documentElement).appendChild(styleEl);"\
+                       "if (document.documentElement) {"\
+                           "insertStyleEl();"\
+                       "}"\
+                       "if (document.readyState === 'loading') {"\
+                           "document.addEventListener('DOMContentLoaded', insertStyleEl);"\
+                       "}"\
+                   "})();").arg(additionalCss.replace("\n", " ").replace("'", "\\'"));
+}
+
+QString LiquidAppLaunchSnapshot::getFilePath(const QString liquidAppName)
+{
+    return Liquid::getSnapshotsDir().absolutePath() + QDir::separator() + liquidAppName + ".launch";
+}
+
+LiquidAppLaunchSnapshot LiquidAppLaunchSnapshot::load(const QString liquidAppName)
+{
+    QElapsedTimer loadElapsedTimer;
+    loadElapsedTimer.start();
+
+    const QFileInfo settingsFileInfo(LiquidSettings::getLiquidAppFilePath(liquidAppName));
+    const QDateTime settingsFileModificationTime = (settingsFileInfo.exists()) ? settingsFileInfo.lastModified() : QDateTime();
+    const qint64 settingsFileSize = (settingsFileInfo.exists()) ? settingsFileInfo.size() : -1;
+
+    const auto isUpToDate = [&](const LiquidAppLaunchSnapshot& snapshot) {
+        return snapshot.settingsFileModificationTime == settingsFileModificationTime && snapshot.settingsFileSize == settingsFileSize;
+    };
+
+    if (launchSnapshots.contains(liquidAppName) && isUpToDate(launchSnapshots.value(liquidAppName))) {
+        return launchSnapshots.value(liquidAppName);
+    }
+
+    LiquidAppLaunchSnapshot snapshot;
+
+    // Nothing to go by unless the settings file exists (e.g. Liquid app that's still being created)
+    if (settingsFileInfo.exists() && (!read(getFilePath(liquidAppName), snapshot) || !isUpToDate(snapshot))) {
+        snapshot = build(liquidAppName);
+        snapshot.loadTime = loadElapsedTimer.nsecsElapsed() / 1000;
+
+        // Spare the next launch from having to do the same
+        if (snapshot.isFromSettingsFile) {
+            write(getFilePath(liquidAppName), snapshot);
+        }
+    } else {
+        snapshot.loadTime = loadElapsedTimer.nsecsElapsed() / 1000;
+    }
+
+    launchSnapshots.insert(liquidAppName, snapshot);
+
+    return snapshot;
+}
+
+bool LiquidAppLaunchSnapshot::read(const QString filePath, LiquidAppLaunchSnapshot& snapshot)
+{
+    QFile snapshotFile(filePath);
+    if (!snapshotFile.open(QIODevice::ReadOnly) || snapshotFile.size() == 0) {
+        return false;
+    }
+
+    uchar* data = snapshotFile.map(0, snapshotFile.size());
+    if (!data) {
+        return false;
+    }
+
+    QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char*>(data), snapshotFile.size()));
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic;
+    quint16 version;
+    qint64 settingsFileModificationTime;
+    in >> magic >> version;
+    // Made by some other version of Liquid, gets replaced
+    if (in.status() != QDataStream::Ok || magic != snapshotMagic || version != snapshotVersion) {
+        snapshotFile.unmap(data);
+        return false;
+    }
+
+    in >> settingsFileModificationTime
+       >> snapshot.settingsFileSize
+       >> snapshot.values
+       >> snapshot.additionalCssScriptSource
+       >> snapshot.additionalJsScriptSource;
+    snapshot.settingsFileModificationTime = QDateTime::fromMSecsSinceEpoch(settingsFileModificationTime);
+
+    const bool isComplete = (in.status() == QDataStream::Ok);
+
+    // Everything that's been read is a copy, nothing refers to mapped memory past this point
+    snapshotFile.unmap(data);
+
+    return isComplete;
+}
+
+bool LiquidAppLaunchSnapshot::store(const QString liquidAppName)
+{
+    const LiquidAppLaunchSnapshot snapshot = build(liquidAppName);
+
+    if (!snapshot.isFromSettingsFile) {
+        return false;
+    }
+
+    return write(getFilePath(liquidAppName), snapshot);
+}
+
+bool LiquidAppLaunchSnapshot::write(const QString filePath, const LiquidAppLaunchSnapshot& snapshot)
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile snapshotFile(filePath);
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qDebug().noquote() << QString("Unable to open file %1 in Write mode").arg(filePath);
+        return false;
+    }
+
+    QDataStream out(&snapshotFile);
+    out.setVersion(QDataStream::Qt_5_6);
+    out << snapshotMagic
+        << snapshotVersion
+        << snapshot.settingsFileModificationTime.toMSecsSinceEpoch()
+        << snapshot.settingsFileSize
+        << snapshot.values
+        << snapshot.additionalCssScriptSource
+        << snapshot.additionalJsScriptSource;
+
+    if (!snapshotFile.commit()) {
+        qDebug().noquote() << QString("Unable to write launch snapshot %1").arg(filePath);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "liquidapplifecycle.hpp"
+
+/*
+ * Pages of Liquid apps that aren't being looked at (minimized or otherwise hidden windows)
+ * keep running their timers, animations and network polling for no one to see.
+ *
+ * After some time of being hidden the page gets frozen: it stays in memory, but nothing runs.
+ * After a longer while it gets discarded altogether, and only its history is kept.
+ * Showing the window again brings the page back, reloading it if it was discarded,
+ * along with where it was scrolled to.
+ *
+ * Neither happens unless enabled for the Liquid app (see its config dialog),
+ * some web apps don't come back in one piece after having been frozen.
+ *
+ * Chromium has the final say: pages that e.g. play audio don't get frozen or discarded.
+ */
+LiquidAppLifecycle::LiquidAppLifecycle(QWebEnginePage* page, const int freezeDelay, const int discardDelay, QObject* parent) : QObject(parent)
+{
+    this->page = page;
+
+    freezeTimer = new QTimer(this);
+    freezeTimer->setSingleShot(true);
+    freezeTimer->setInterval(freezeDelay * 1000);
+    connect(freezeTimer, &QTimer::timeout, this, [this]() {
+        freezeIsDue = true;
+        update();
+    });
+
+    discardTimer = new QTimer(this);
+    discardTimer->setSingleShot(true);
+    discardTimer->setInterval(discardDelay * 1000);
+    connect(discardTimer, &QTimer::timeout, this, [this]() {
+        discardIsDue = true;
+        update();
+    });
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    connect(page, &QWebEnginePage::visibleChanged, this, &LiquidAppLifecycle::onVisibleChanged);
+    connect(page, &QWebEnginePage::recommendedStateChanged, this, &LiquidAppLifecycle::update);
+    connect(page, &QWebEnginePage::loadFinished, this, &LiquidAppLifecycle::onLoadFinished);
+#endif
+}
+
+void LiquidAppLifecycle::discard(void)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    if (page->lifecycleState() == QWebEnginePage::LifecycleState::Discarded) {
+        return;
+    }
+
+    // Only hidden pages can be discarded; one that's being looked at gets brought right back, reloaded
+    const bool wasVisible = page->isVisible();
+    if (wasVisible) {
+        page->setVisible(false);
+    }
+
+    scrollPosition = page->scrollPosition();
+    page->setLifecycleState(QWebEnginePage::LifecycleState::Discarded);
+
+    if (wasVisible) {
+        page->setVisible(true);
+    }
+#else
+    page->triggerAction(QWebEnginePage::Reload);
+#endif
+}
+
+void LiquidAppLifecycle::onLoadFinished(const bool ok)
+{
+    if (!ok || !scrollPositionIsPendingRestore) {
+        return;
+    }
+
+    scrollPositionIsPendingRestore = false;
+
+    // Works regardless of JavaScript being enabled for the Liquid app
+    page->runJavaScript(QString("window.scrollTo(%1, %2);").arg(scrollPosition.x()).arg(scrollPosition.y()),
+                        QWebEngineScript::ApplicationWorld);
+}
+
+void LiquidAppLifecycle::onVisibleChanged(const bool visible)
+{
+    freezeIsDue = false;
+    discardIsDue = false;
+
+    if (visible) {
+        freezeTimer->stop();
+        discardTimer->stop();
+    } else {
+        // Zero (or less) means never
+        if (freezeTimer->interval() > 0) {
+            freezeTimer->start();
+        }
+        if (discardTimer->interval() > 0) {
+            discardTimer->start();
+        }
+    }
+
+    update();
+}
+
+void LiquidAppLifecycle::update(void)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    typedef QWebEnginePage::LifecycleState LifecycleState;
+
+    // Visible pages must be active
+    if (page->isVisible()) {
+        if (page->lifecycleState() != LifecycleState::Active) {
+            scrollPositionIsPendingRestore = (page->lifecycleState() == LifecycleState::Discarded);
+            page->setLifecycleState(LifecycleState::Active);
+        }
+
+        return;
+    }
+
+    // How far it's been hidden long enough to go
+    LifecycleState state = LifecycleState::Active;
+    if (discardIsDue) {
+        state = LifecycleState::Discarded;
+    } else if (freezeIsDue) {
+        state = LifecycleState::Frozen;
+    }
+
+    // How far Chromium thinks it's safe to go
+    state = qMin(state, page->recommendedState());
+
+    // Pages only go further while hidden, it's becoming visible that brings them back
+    if (state <= page->lifecycleState()) {
+        return;
+    }
+
+    if (state == LifecycleState::Discarded) {
+        scrollPosition = page->scrollPosition();
+    }
+
+    page->setLifecycleState(state);
+#endif
+}
@@ -0,0 +1,86 @@
+#include "liquid.hpp"
+#include "liquidappmemorywatchdog.hpp"
+#include "lqd.h"
+
+/*
+ * Some web pages leak memory for as long as they stay open.
+ * The watchdog keeps an eye on how much memory the renderer process of Liquid app's web page takes:
+ * going over the soft limit gets the user warned, going over the hard limit
+ * gets the page discarded and loaded again.
+ *
+ * Every time either of the limits gets crossed, a line gets appended to a CSV file
+ * within the logs directory, to see which Liquid apps leak and how fast.
+ */
+LiquidAppMemoryWatchdog::LiquidAppMemoryWatchdog(const QString liquidAppName, QWebEnginePage* page, const qint64 softLimit, const qint64 hardLimit, QObject* parent) : QObject(parent)
+{
+    this->liquidAppName = liquidAppName;
+    this->page = page;
+    this->softLimit = softLimit;
+    this->hardLimit = hardLimit;
+
+    checkTimer = new QTimer(this);
+    checkTimer->setInterval(LQD_WATCHDOG_MEMORY_INTERVAL);
+    connect(checkTimer, &QTimer::timeout, this, &LiquidAppMemoryWatchdog::check);
+
+    if (softLimit > 0 || hardLimit > 0) {
+        checkTimer->start();
+    }
+}
+
+void LiquidAppMemoryWatchdog::check(void)
+{
+    qint64 renderProcessId = -1;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+    renderProcessId = page->renderProcessPid();
+#endif
+
+    // No renderer (yet, or anymore) means nothing to look after
+    const qint64 memoryUsage = (renderProcessId > 0) ? Liquid::getProcessResidentSetSize(renderProcessId) : -1;
+    if (memoryUsage < 0) {
+        if (overSoftLimit) {
+            overSoftLimit = false;
+            emit softLimitExceededChanged(overSoftLimit);
+        }
+        return;
+    }
+
+    if (hardLimit > 0 && memoryUsage > hardLimit) {
+        if (!lastHardLimitActionTime.isValid()
+            || lastHardLimitActionTime.msecsTo(QDateTime::currentDateTimeUtc()) > LQD_WATCHDOG_MEMORY_COOLDOWN
+        ) {
+            lastHardLimitActionTime = QDateTime::currentDateTimeUtc();
+            log(renderProcessId, memoryUsage, "hard-limit");
+            emit hardLimitExceeded();
+        }
+    }
+
+    const bool isOverSoftLimitNow = softLimit > 0 && memoryUsage > softLimit;
+    if (isOverSoftLimitNow != overSoftLimit) {
+        overSoftLimit = isOverSoftLimitNow;
+
+        if (overSoftLimit) {
+            log(renderProcessId, memoryUsage, "soft-limit");
+        }
+
+        emit softLimitExceededChanged(overSoftLimit);
+    }
+}
+
+bool LiquidAppMemoryWatchdog::isOverSoftLimit(void)
+{
+    return overSoftLimit;
+}
+
+void LiquidAppMemoryWatchdog::log(const qint64 renderProcessId, const qint64 memoryUsage, const QString event)
+{
+    // Memory figures are in bytes
+    Liquid::appendLogRecord(LQD_WATCHDOG_MEMORY_LOG_NAME,
+                            QStringList() << "Time" << "LiquidApp" << "RenderProcessID" << "MemoryUsage" << "SoftLimit" << "HardLimit" << "Event",
+                            QStringList() << QDateTime::currentDateTimeUtc().toString(Qt::ISODate)
+                                          << liquidAppName
+                                          << QString::number(renderProcessId)
+                                          << QString::number(memoryUsage)
+                                          << QString::number(softLimit)
+                                          << QString::number(hardLimit)
+                                          << event);
+}
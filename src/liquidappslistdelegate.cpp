@@ -0,0 +1,135 @@
+#include <QAbstractItemView>
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+
+#include "liquidappslistdelegate.hpp"
+#include "liquidappslistmodel.hpp"
+#include "liquidappslistview.hpp"
+#include "lqd.h"
+
+// Indexed by LiquidAppsListDelegate::Action
+static const char* actionIcons[] = { LQD_ICON_DELETE, LQD_ICON_EDIT, LQD_ICON_RUN };
+
+LiquidAppsListDelegate::LiquidAppsListDelegate(QObject* parent) : QStyledItemDelegate(parent)
+{
+}
+
+bool LiquidAppsListDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index)
+{
+    if (index.column() != LiquidAppsListModel::ActionsColumn) {
+        if (event->type() == QEvent::MouseMove) {
+            setHoveredAction(option.widget, QModelIndex(), NoAction);
+        }
+
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+
+    switch (event->type()) {
+        case QEvent::MouseMove:
+            setHoveredAction(option.widget, index, getActionAt(option.rect, static_cast<QMouseEvent*>(event)->pos()));
+            break;
+
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonDblClick:
+            // Clicking action buttons should neither select the row nor run the app
+            return getActionAt(option.rect, static_cast<QMouseEvent*>(event)->pos()) != NoAction;
+
+        case QEvent::MouseButtonRelease:
+            {
+                const QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+                const Action action = getActionAt(option.rect, mouseEvent->pos());
+
+                if (mouseEvent->button() == Qt::LeftButton && action != NoAction) {
+                    emit actionTriggered(action, index);
+                    return true;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+LiquidAppsListDelegate::Action LiquidAppsListDelegate::getActionAt(const QRect& rect, const QPoint& pos)
+{
+    for (int action = 0; action < ActionCount; action++) {
+        if (getActionRect(rect, static_cast<Action>(action)).contains(pos)) {
+            return static_cast<Action>(action);
+        }
+    }
+
+    return NoAction;
+}
+
+QRect LiquidAppsListDelegate::getActionRect(const QRect& rect, const Action action)
+{
+    // Buttons are lined up against the right edge of the cell
+    return QRect(rect.right() + 1 - (ActionCount - action) * LQD_APP_LIST_BTN_W, rect.top(), LQD_APP_LIST_BTN_W, rect.height());
+}
+
+void LiquidAppsListDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    if (index.column() != LiquidAppsListModel::ActionsColumn) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Paint the cell itself the same way all other cells get painted
+    QStyleOptionViewItem cellOption(option);
+    initStyleOption(&cellOption, index);
+    const QStyle* style = (option.widget) ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &cellOption, painter, option.widget);
+
+    // Paint action buttons on top of it, hover colors come from the stylesheet
+    const LiquidAppsListView* listView = qobject_cast<const LiquidAppsListView*>(option.widget);
+    painter->save();
+    for (int action = 0; action < ActionCount; action++) {
+        const QRect actionRect = getActionRect(option.rect, static_cast<Action>(action));
+        const bool isHovered = (option.state & QStyle::State_MouseOver) && hoveredIndex == index && hoveredAction == action;
+
+        if (isHovered && listView) {
+            painter->fillRect(actionRect, listView->getActionHoverBackgroundColor(static_cast<Action>(action)));
+            painter->setPen(listView->getActionHoverColor(static_cast<Action>(action)));
+        } else if (isHovered) {
+            painter->setPen(cellOption.palette.color(QPalette::Highlight));
+        } else {
+            painter->setPen(cellOption.palette.color(QPalette::Text));
+        }
+
+        painter->drawText(actionRect, Qt::AlignCenter, QString::fromUtf8(actionIcons[action]));
+    }
+    painter->restore();
+}
+
+void LiquidAppsListDelegate::setHoveredAction(const QWidget* view, const QModelIndex& index, const Action action)
+{
+    if (hoveredIndex == index && hoveredAction == action) {
+        return;
+    }
+
+    hoveredIndex = index;
+    hoveredAction = action;
+
+    const QAbstractItemView* itemView = qobject_cast<const QAbstractItemView*>(view);
+    if (itemView) {
+        if (action != NoAction) {
+            itemView->viewport()->setCursor(Qt::PointingHandCursor);
+        } else {
+            itemView->viewport()->unsetCursor();
+        }
+        itemView->viewport()->update();
+    }
+}
+
+QSize LiquidAppsListDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    if (index.column() != LiquidAppsListModel::ActionsColumn) {
+        return QStyledItemDelegate::sizeHint(option, index);
+    }
+
+    return QSize(ActionCount * LQD_APP_LIST_BTN_W, QStyledItemDelegate::sizeHint(option, index).height());
+}
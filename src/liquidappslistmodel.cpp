@@ -0,0 +1,153 @@
+#include <QLocale>
+#include <QSet>
+
+#include "liquid.hpp"
+#include "liquidappiconcache.hpp"
+#include "liquidappslistmodel.hpp"
+
+LiquidAppsListModel::LiquidAppsListModel(QObject* parent) : QAbstractTableModel(parent)
+{
+}
+
+int LiquidAppsListModel::columnCount(const QModelIndex& parent) const
+{
+    return (parent.isValid()) ? 0 : ColumnCount;
+}
+
+QVariant LiquidAppsListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+
+    const LiquidAppIndex::Entry& entry = entries.at(index.row());
+
+    if (index.column() == NameColumn) {
+        switch (role) {
+            case Qt::DisplayRole:
+                return entry.name;
+
+            case Qt::DecorationRole:
+                return getIcon(entry);
+
+            case Qt::ToolTipRole:
+                return entry.url;
+        }
+    } else if (index.column() == StatusColumn && instanceRecords.contains(entry.name)) {
+        const LiquidInstanceRegistry::Record& record = instanceRecords[entry.name];
+        // Renderer process is what belongs to this Liquid app alone (the rest may be shared with others, see LiquidAppHost)
+        const bool isRenderProcessKnown = record.renderProcessMemoryUsage >= 0;
+        const qreal cpuUsage = (isRenderProcessKnown) ? record.renderProcessCpuUsage : record.cpuUsage;
+
+        switch (role) {
+            case Qt::DisplayRole:
+                return QString("%1, %2%")
+                    .arg(Liquid::getReadableMemoryUsage((isRenderProcessKnown) ? record.renderProcessMemoryUsage : record.memoryUsage))
+                    .arg(qMax(cpuUsage, 0.0), 0, 'f', 0);
+
+            case Qt::TextAlignmentRole:
+                return int(Qt::AlignRight | Qt::AlignVCenter);
+
+            case Qt::ToolTipRole:
+                return QString("Running since %1\nProcess %2: %3, %4% CPU\nRenderer process %5: %6, %7% CPU")
+                    .arg(QLocale().toString(record.startTime.toLocalTime(), QLocale::ShortFormat))
+                    .arg(record.processId)
+                    .arg(Liquid::getReadableMemoryUsage(record.memoryUsage))
+                    .arg(qMax(record.cpuUsage, 0.0), 0, 'f', 1)
+                    .arg(record.renderProcessId)
+                    .arg(Liquid::getReadableMemoryUsage(record.renderProcessMemoryUsage))
+                    .arg(qMax(record.renderProcessCpuUsage, 0.0), 0, 'f', 1);
+        }
+    }
+
+    return QVariant();
+}
+
+Qt::ItemFlags LiquidAppsListModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    // Read-only (no text edit upon double-click)
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QIcon LiquidAppsListModel::getIcon(const LiquidAppIndex::Entry& entry) const
+{
+    QHash<QString, QIcon>::const_iterator icon = icons.constFind(entry.name);
+
+    if (icon != icons.constEnd()) {
+        return *icon;
+    }
+
+    QIcon cachedIcon = LiquidAppIconCache::getIcon(entry.icon);
+    if (cachedIcon.isNull()) {
+        cachedIcon = QIcon(":/images/" PROG_NAME ".svg");
+    }
+    icons.insert(entry.name, cachedIcon);
+
+    return cachedIcon;
+}
+
+QString LiquidAppsListModel::getLiquidAppName(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QString();
+    }
+
+    return entries.at(index.row()).name;
+}
+
+int LiquidAppsListModel::rowCount(const QModelIndex& parent) const
+{
+    return (parent.isValid()) ? 0 : entries.size();
+}
+
+void LiquidAppsListModel::setEntries(const QList<LiquidAppIndex::Entry> entries)
+{
+    // Both lists are sorted the same way, which lets rows be removed and inserted in place
+    QSet<QString> liquidAppNames;
+    foreach (const LiquidAppIndex::Entry entry, entries) {
+        liquidAppNames.insert(entry.name);
+    }
+
+    // Remove rows of Liquid apps that are gone
+    for (int row = this->entries.size() - 1; row >= 0; row--) {
+        if (!liquidAppNames.contains(this->entries.at(row).name)) {
+            beginRemoveRows(QModelIndex(), row, row);
+            icons.remove(this->entries.at(row).name);
+            this->entries.removeAt(row);
+            endRemoveRows();
+        }
+    }
+
+    // Insert rows of new Liquid apps, update rows of ones that have changed
+    for (int row = 0; row < entries.size(); row++) {
+        const LiquidAppIndex::Entry& entry = entries.at(row);
+
+        if (row < this->entries.size() && this->entries.at(row).name == entry.name) {
+            if (this->entries.at(row).modificationTime != entry.modificationTime || this->entries.at(row).size != entry.size) {
+                icons.remove(entry.name);
+                this->entries[row] = entry;
+                emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+            }
+        } else {
+            beginInsertRows(QModelIndex(), row, row);
+            this->entries.insert(row, entry);
+            endInsertRows();
+        }
+    }
+}
+
+void LiquidAppsListModel::setInstanceRecords(const QList<LiquidInstanceRegistry::Record> records)
+{
+    instanceRecords.clear();
+    foreach (const LiquidInstanceRegistry::Record record, records) {
+        instanceRecords.insert(record.liquidAppName, record);
+    }
+
+    if (entries.size() > 0) {
+        emit dataChanged(index(0, StatusColumn), index(entries.size() - 1, StatusColumn));
+    }
+}
@@ -0,0 +1,52 @@
+#include "liquidappslistview.hpp"
+
+/*
+ * Table view the delegate paints Liquid apps' action buttons into.
+ * It only exists to let stylesheets decide what those buttons look like on hover
+ * (by means of qproperty-*), the way they used to when those were actual push buttons.
+ * Colors that don't get set fall back onto the view's palette.
+ */
+LiquidAppsListView::LiquidAppsListView(QWidget* parent) : QTableView(parent)
+{
+}
+
+QColor LiquidAppsListView::getActionHoverBackgroundColor(const LiquidAppsListDelegate::Action action) const
+{
+    switch (action) {
+        case LiquidAppsListDelegate::DeleteAction:
+            return deleteActionHoverBackgroundColor;
+
+        case LiquidAppsListDelegate::EditAction:
+            return editActionHoverBackgroundColor;
+
+        case LiquidAppsListDelegate::RunAction:
+            return runActionHoverBackgroundColor;
+
+        default:
+            return Qt::transparent;
+    }
+}
+
+QColor LiquidAppsListView::getActionHoverColor(const LiquidAppsListDelegate::Action action) const
+{
+    QColor color;
+
+    switch (action) {
+        case LiquidAppsListDelegate::DeleteAction:
+            color = deleteActionHoverColor;
+            break;
+
+        case LiquidAppsListDelegate::EditAction:
+            color = editActionHoverColor;
+            break;
+
+        case LiquidAppsListDelegate::RunAction:
+            color = runActionHoverColor;
+            break;
+
+        default:
+            break;
+    }
+
+    return (color.isValid()) ? color : palette().color(QPalette::Highlight);
+}
@@ -38,7 +38,7 @@ void LiquidAppWebPage::addAllowedDomains(const QStringList domainsList) {
 
 bool LiquidAppWebPage::acceptNavigationRequest(const QUrl& reqUrl, const QWebEnginePage::NavigationType navReqType, const bool isMainFrame)
 {
-    const bool isDomainAllowed = allowedDomainsList->contains(reqUrl.host());
+    const bool isDomainAllowed = this->isDomainAllowed(reqUrl.host());
     const bool isKeyModifierActive = QGuiApplication::keyboardModifiers().testFlag(Qt::ControlModifier);
 
     // Top-level window
@@ -123,6 +123,17 @@ void LiquidAppWebPage::closeJsDialog()
     }
 }
 
+bool LiquidAppWebPage::isDialogOpen(void) const
+{
+    // Renderer waits for the answer to whichever dialog is currently shown
+    return dialogWidget != Q_NULLPTR;
+}
+
+bool LiquidAppWebPage::isDomainAllowed(const QString domain)
+{
+    return allowedDomainsList->contains(domain);
+}
+
 void LiquidAppWebPage::javaScriptAlert(const QUrl& securityOrigin, const QString& msg)
 {
     Q_UNUSED(securityOrigin);
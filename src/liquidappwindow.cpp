@@ -1,9 +1,17 @@
 #include <QApplication>
-#include <QBuffer>
 #include <QDir>
 #include <QClipboard>
+#include <QDateTime>
+#include <QDesktopServices>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QGraphicsOpacityEffect>
 #include <QNetworkProxy>
 #include <QPainter>
+#include <QPointer>
+#include <QPropertyAnimation>
+#include <QSaveFile>
 #include <QScreen>
 #include <QTimer>
 #include <QWebEngineHistory>
@@ -13,8 +21,16 @@
 
 #include "liquid.hpp"
 #include "liquidappcookiejar.hpp"
+#include "liquidapphealthwatchdog.hpp"
+#include "liquidappiconcache.hpp"
+#include "liquidapplaunchsnapshot.hpp"
+#include "liquidapplifecycle.hpp"
+#include "liquidappmemorywatchdog.hpp"
 #include "liquidappwebpage.hpp"
 #include "liquidappwindow.hpp"
+#include "liquidinstanceregistry.hpp"
+#include "liquidsettings.hpp"
+#include "liquidthemeservice.hpp"
 #include "lqd.h"
 #ifdef Q_OS_MAC
 #include "SetWindowBackgroundColor.h"
@@ -22,29 +38,12 @@
 
 LiquidAppWindow::LiquidAppWindow(const QString* name) : QWebEngineView()
 {
+    // Startup stages get timed from here on (see LQD_LAUNCH_LOG_NAME)
+    launchElapsedTimer.start();
+
     // Prevent window from getting way too tiny
     setMinimumSize(LQD_APP_WIN_MIN_SIZE_W, LQD_APP_WIN_MIN_SIZE_H);
 
-    // Tune web engine
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--enable-features=AutoplayIgnoreWebAudio");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--enable-accelerated-video-decode");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--enable-gpu-compositing");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--enable-gpu-rasterization");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--enable-smooth-scrolling");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--ignore-gpu-blocklist");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--num-raster-threads=4");
-    qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--use-fake-ui-for-media-stream");
-
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    // Ensure dark mode is enabled on the web page in case the system theme is dark
-    if (Liquid::detectDarkMode()) {
-        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--force-dark-mode");
-        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--blink-settings=forceDarkModeEnabled=true");
-        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--blink-settings=darkMode=4");
-        qputenv("QTWEBENGINE_CHROMIUM_FLAGS", qgetenv("QTWEBENGINE_CHROMIUM_FLAGS") + " " + "--blink-settings=darkModeEnabled=true");
-    }
-#endif
-
     // Set default icon
 #if !defined(Q_OS_LINUX) // This doesn't work on X11
     setWindowIcon(QIcon(":/images/" PROG_NAME ".svg"));
@@ -55,11 +54,7 @@ LiquidAppWindow::LiquidAppWindow(const QString* name) : QWebEngineView()
 
     liquidAppName = (QString*)name;
 
-    liquidAppConfig = new QSettings(QSettings::IniFormat,
-                                    QSettings::UserScope,
-                                    QString(PROG_NAME "%1" LQD_APPS_DIR_NAME).arg(QDir::separator()),
-                                    *name,
-                                    Q_NULLPTR);
+    liquidAppConfig = LiquidSettings::forLiquidApp(*name);
 
     // These default settings affect everything (including sub-frames)
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -71,18 +66,35 @@ LiquidAppWindow::LiquidAppWindow(const QString* name) : QWebEngineView()
     liquidAppWebProfile->setPersistentCookiesPolicy(QWebEngineProfile::NoPersistentCookies);
 
     if (!liquidAppWebProfile->isOffTheRecord()) {
-        qDebug().noquote() << "Web profile is not off-the-record!";
-        // Privacy is paramount for this program, separate apps need to be completely siloed
-        exit(EXIT_FAILURE);
+        qDebug().noquote() << QString("Web profile of Liquid app “%1” is not off-the-record, closing its window").arg(*liquidAppName);
+        // Privacy is paramount for this program, separate apps need to be completely siloed;
+        // only this window goes away, other Liquid apps may be running within the same process (see LiquidAppHost)
+        deleteLater();
+        return;
     }
 
-    Liquid::applyQtStyleSheets(this);
-
     liquidAppWebPage = new LiquidAppWebPage(liquidAppWebProfile, this);
     setPage(liquidAppWebPage);
 
     liquidAppWebSettings = liquidAppWebPage->settings();
 
+    // Let others know this Liquid app is running, and how many resources it takes
+    liquidAppInstanceRegistry = new LiquidInstanceRegistry(*name, liquidAppWebPage, this);
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    // Keep web page's color scheme in line with the system theme without having to restart
+    liquidAppWebSettings->setAttribute(QWebEngineSettings::ForceDarkMode, LiquidThemeService::instance()->isDarkMode());
+    connect(LiquidThemeService::instance(), &LiquidThemeService::darkModeChanged, this, [this](const bool isDarkMode) {
+        liquidAppWebSettings->setAttribute(QWebEngineSettings::ForceDarkMode, isDarkMode);
+    });
+#endif
+
+    // Coalesce moves and resizes (e.g. dragging window's edge) into a single snapshot of window's geometry
+    windowGeometryTimer = new QTimer(this);
+    windowGeometryTimer->setSingleShot(true);
+    windowGeometryTimer->setInterval(LQD_WIN_GEOM_DEBOUNCE);
+    connect(windowGeometryTimer, &QTimer::timeout, this, &LiquidAppWindow::snapshotWindowGeometry);
+
     // Set default window title
     liquidAppWindowTitle = *liquidAppName;
 
@@ -120,7 +132,46 @@ LiquidAppWindow::LiquidAppWindow(const QString* name) : QWebEngineView()
 
     liquidAppWebPage->addAllowedDomain(startingUrl.host());
 
+    // Web page's own settings, zoom level, background color and scripts have to be in place before navigation starts
     loadLiquidAppConfig();
+    launchConfigAppliedTime = launchElapsedTimer.nsecsElapsed() / 1000;
+
+    // Show what the Liquid app looked like last time, until the web page gets painted
+    showSplash();
+
+    // Trigger window title update if <title> changes
+    connect(this, &QWebEngineView::titleChanged, this, &LiquidAppWindow::updateWindowTitle);
+
+    // Update Liquid app's icon using the one provided by the website
+    connect(liquidAppWebPage, &QWebEnginePage::iconChanged, this, &LiquidAppWindow::onIconChanged);
+
+    // Catch loading's start
+    connect(liquidAppWebPage, &QWebEnginePage::loadStarted, this, &LiquidAppWindow::loadStarted);
+
+    // Catch loading's end
+    connect(liquidAppWebPage, &QWebEnginePage::loadFinished, this, &LiquidAppWindow::loadFinished);
+
+    // Zoom level set before the first navigation only sticks with some versions of Qt,
+    // put it back once the new document is committed, which is before anything of it gets painted
+    connect(liquidAppWebPage, &QWebEnginePage::urlChanged, this, [this]() {
+        if (!qFuzzyCompare(zoomFactor(), zoomFactorInEffect)) {
+            setZoomFactor(zoomFactorInEffect);
+        }
+
+        // There's a new document now, see when it gets painted
+        if (splash && !splashTimer->isActive()) {
+            splashTimer->start();
+        }
+    });
+
+    // Load Liquid app's starting URL as soon as cookies for its host are in place;
+    // they're read off the GUI thread, while the window gets revealed and set up below
+    connect(liquidAppCookieJar, &LiquidAppCookieJar::startingUrlCookiesRestored, this, [this, startingUrl](){
+        load((urlToOpen.isValid()) ? urlToOpen : startingUrl);
+        startingUrlIsLoaded = true;
+        launchNavigationStartedTime = launchElapsedTimer.nsecsElapsed() / 1000;
+    });
+    liquidAppCookieJar->restoreCookies(page()->profile()->cookieStore(), startingUrl);
 
     // Reveal Liquid app's window and bring it to front
     show();
@@ -134,37 +185,57 @@ LiquidAppWindow::LiquidAppWindow(const QString* name) : QWebEngineView()
 #endif
     raise();
     activateWindow();
+    launchWindowShownTime = launchElapsedTimer.nsecsElapsed() / 1000;
 
     // Connect keyboard shortcuts
     bindKeyboardShortcuts();
 
     // Initialize context menu
     setupContextMenu();
-
-    // Trigger window title update if <title> changes
-    connect(this, &QWebEngineView::titleChanged, this, &LiquidAppWindow::updateWindowTitle);
-
-    // Update Liquid app's icon using the one provided by the website
-    connect(liquidAppWebPage, &QWebEnginePage::iconChanged, this, &LiquidAppWindow::onIconChanged);
-
-    // Catch loading's start
-    connect(liquidAppWebPage, &QWebEnginePage::loadStarted, this, &LiquidAppWindow::loadStarted);
-
-    // Catch loading's end
-    connect(liquidAppWebPage, &QWebEnginePage::loadFinished, this, &LiquidAppWindow::loadFinished);
-
-    // Load Liquid app's starting URL
-    load(startingUrl);
+    launchUiReadyTime = launchElapsedTimer.nsecsElapsed() / 1000;
 }
 
 LiquidAppWindow::~LiquidAppWindow(void)
 {
-    saveLiquidAppConfig();
+    // Nothing to save unless the window got to be set up (see constructor)
+    if (liquidAppWebPage) {
+        saveLiquidAppConfig();
+    }
 
     delete liquidAppWebPage;
     delete liquidAppWebProfile;
 }
 
+void LiquidAppWindow::activate(const QUrl url)
+{
+    // Failed to get set up and is about to be gone (see constructor)
+    if (!liquidAppWebPage) {
+        return;
+    }
+
+    // Bring Liquid app's window to front
+    setWindowState(windowState() & ~Qt::WindowMinimized);
+    show();
+    raise();
+    activateWindow();
+
+    if (!url.isValid()) {
+        return;
+    }
+
+    // Same rule as for links clicked within the Liquid app
+    if (!liquidAppWebPage->isDomainAllowed(url.host())) {
+        QDesktopServices::openUrl(url);
+        return;
+    }
+
+    if (startingUrlIsLoaded) {
+        load(url);
+    } else {
+        urlToOpen = url;
+    }
+}
+
 void LiquidAppWindow::attemptToSetZoomFactorTo(const qreal desiredZoomFactor)
 {
     int i = 0;
@@ -172,7 +243,8 @@ void LiquidAppWindow::attemptToSetZoomFactorTo(const qreal desiredZoomFactor)
 
     for (; i < ilen; i++) {
         if (qFuzzyCompare(zoomFactors[i], desiredZoomFactor)) {
-            setZoomFactor(zoomFactors[i]);
+            zoomFactorInEffect = zoomFactors[i];
+            setZoomFactor(zoomFactorInEffect);
             return;
         }
     }
@@ -180,7 +252,8 @@ void LiquidAppWindow::attemptToSetZoomFactorTo(const qreal desiredZoomFactor)
     // Attempt to determine closest zoom level to snap to
     for (i = 0; i < ilen; i++) {
         if ((i == 0 || zoomFactors[i - 1] < desiredZoomFactor) && (i == ilen - 1 || zoomFactors[i + 1] > desiredZoomFactor)) {
-            setZoomFactor(zoomFactors[i]);
+            zoomFactorInEffect = zoomFactors[i];
+            setZoomFactor(zoomFactorInEffect);
             return;
         }
     }
@@ -349,6 +422,9 @@ void LiquidAppWindow::certificateError(void)
 
 void LiquidAppWindow::closeEvent(QCloseEvent* event)
 {
+    // Whatever is on screen right now is what gets shown next time while the web page is loading
+    saveSplash();
+
     event->accept();
     deleteLater();
 }
@@ -391,6 +467,11 @@ bool LiquidAppWindow::eventFilter(QObject* watched, QEvent* event)
         }
     }
 
+    // Web engine's render widget may get created after the splash, it mustn't end up on top of it
+    if (watched == this && event->type() == QEvent::ChildAdded && splash) {
+        QMetaObject::invokeMethod(splash, "raise", Qt::QueuedConnection);
+    }
+
     return QWebEngineView::eventFilter(watched, event);
 }
 
@@ -400,14 +481,21 @@ void LiquidAppWindow::exitFullScreenMode(void)
     setWindowState(windowState() & ~Qt::WindowFullScreen);
 
     if (windowGeometryIsLocked) {
-        // Pause here to wait for any kind of window resize animations to finish
-        Liquid::sleep(200);
-
-        setMinimumSize(width(), height());
-        setMaximumSize(width(), height());
+        // Wait for any kind of window resize animations to finish
+        QTimer::singleShot(LQD_WIN_GEOM_DEBOUNCE, this, [this]() {
+            if (windowGeometryIsLocked && !isFullScreen()) {
+                setMinimumSize(width(), height());
+                setMaximumSize(width(), height());
+            }
+        });
     }
 }
 
+QString LiquidAppWindow::getSplashFilePath(const QString liquidAppName)
+{
+    return Liquid::getSnapshotsDir().absolutePath() + QDir::separator() + liquidAppName + ".png";
+}
+
 bool LiquidAppWindow::handleWheelEvent(QWheelEvent *event)
 {
     const bool isCtrlActive = event->modifiers() & Qt::ControlModifier;
@@ -458,10 +546,35 @@ void LiquidAppWindow::hardReload(void)
     setUrl(url);
 }
 
+void LiquidAppWindow::hideSplash(void)
+{
+    if (!splash) {
+        return;
+    }
+
+    splashTimer->stop();
+
+    // Cross-fade into the web page, then get rid of it
+    QGraphicsOpacityEffect* splashOpacityEffect = new QGraphicsOpacityEffect(splash);
+    splash->setGraphicsEffect(splashOpacityEffect);
+
+    QPropertyAnimation* splashAnimation = new QPropertyAnimation(splashOpacityEffect, "opacity", splash);
+    splashAnimation->setDuration(LQD_SPLASH_FADE_DURATION);
+    splashAnimation->setStartValue(1.0);
+    splashAnimation->setEndValue(0.0);
+    connect(splashAnimation, &QPropertyAnimation::finished, splash, &QLabel::deleteLater);
+    splashAnimation->start();
+
+    splash = Q_NULLPTR;
+}
+
 void LiquidAppWindow::loadFinished(bool ok)
 {
     pageIsLoading = false;
 
+    // Whatever got loaded (even if it's an error page) is better than the splash by now
+    hideSplash();
+
     if (ok) {
         pageHasError = false;
     } else {
@@ -477,6 +590,34 @@ void LiquidAppWindow::loadFinished(bool ok)
         forgiveNextPageLoadError = false;
     }
 
+    // Every back/forward history entry holds on to some page state;
+    // individual entries can't be dropped, so start over once there are way too many
+    // (not as soon as over the limit, that would leave going back barely usable)
+    if (lowMemoryMode && history()->count() > LQD_LOW_MEMORY_HISTORY_LIMIT * 2) {
+        history()->clear();
+    }
+
+    // Chromium knows best when the page got painted for the first time
+    if (!launchIsLogged && launchNavigationStartedTime > -1) {
+        launchIsLogged = true;
+
+        QPointer<LiquidAppWindow> window(this);
+        liquidAppWebPage->runJavaScript("(()=>{"\
+                                            "const paintEntries = performance.getEntriesByType('paint');"\
+                                            "return (paintEntries.length > 0) ? paintEntries[0].startTime : -1;"\
+                                        "})();",
+                                        QWebEngineScript::ApplicationWorld,
+                                        [window](const QVariant& result) {
+            if (!window) {
+                return;
+            }
+
+            // Milliseconds since navigation started
+            const qreal firstPaintStartTime = (result.isValid()) ? result.toDouble() : -1;
+            window->logLaunch((firstPaintStartTime >= 0) ? window->launchNavigationStartedTime + qRound64(firstPaintStartTime * 1000) : -1);
+        });
+    }
+
     updateWindowTitle(title());
 }
 
@@ -553,13 +694,11 @@ void LiquidAppWindow::loadLiquidAppConfig(void)
 
     // Deal with Cookies
     {
-        LiquidAppCookieJar *liquidAppCookieJar = new LiquidAppCookieJar(this);
+        liquidAppCookieJar = new LiquidAppCookieJar(this);
         QWebEngineCookieStore *cookieStore = page()->profile()->cookieStore();
 
         connect(cookieStore, &QWebEngineCookieStore::cookieAdded, liquidAppCookieJar, &LiquidAppCookieJar::upsertCookie);
         connect(cookieStore, &QWebEngineCookieStore::cookieRemoved, liquidAppCookieJar, &LiquidAppCookieJar::removeCookie);
-
-        liquidAppCookieJar->restoreCookies(cookieStore);
     }
 
     // Restore window geometry
@@ -597,16 +736,43 @@ void LiquidAppWindow::loadLiquidAppConfig(void)
         page()->setAudioMuted(liquidAppConfig->value(LQD_CFG_KEY_NAME_MUTE_AUDIO).toBool());
     }
 
-    // Restore web view zoom level
+    // Keep as little as possible in memory (see Liquid::getChromiumFlags() for the rest of it)
+    lowMemoryMode = Liquid::isLowMemoryModeEnabled(liquidAppConfig);
+    if (lowMemoryMode) {
+        liquidAppWebProfile->setHttpCacheMaximumSize(LQD_LOW_MEMORY_HTTP_CACHE_SIZE);
+    }
+
+    // Freeze and later discard the web page while it's hidden
+    liquidAppLifecycle = new LiquidAppLifecycle(liquidAppWebPage,
+                                                liquidAppConfig->value(LQD_CFG_KEY_NAME_LIFECYCLE_FREEZE_DELAY, LQD_LIFECYCLE_FREEZE_DELAY).toInt(),
+                                                liquidAppConfig->value(LQD_CFG_KEY_NAME_LIFECYCLE_DISCARD_DELAY, LQD_LIFECYCLE_DISCARD_DELAY).toInt(),
+                                                this);
+
+    // Keep an eye on web page leaking memory
+    liquidAppMemoryWatchdog = new LiquidAppMemoryWatchdog(*liquidAppName,
+                                                          liquidAppWebPage,
+                                                          liquidAppConfig->value(LQD_CFG_KEY_NAME_WATCHDOG_SOFT_LIMIT, 0).toLongLong() * 1024 * 1024,
+                                                          liquidAppConfig->value(LQD_CFG_KEY_NAME_WATCHDOG_HARD_LIMIT, 0).toLongLong() * 1024 * 1024,
+                                                          this);
+    connect(liquidAppMemoryWatchdog, &LiquidAppMemoryWatchdog::softLimitExceededChanged, this, [this]() {
+        updateWindowTitle(title());
+    });
+    connect(liquidAppMemoryWatchdog, &LiquidAppMemoryWatchdog::hardLimitExceeded, liquidAppLifecycle, &LiquidAppLifecycle::discard);
+
+    // Bring web page back when its renderer crashes or hangs, keep count of how often that happens
+    liquidAppHealthWatchdog = new LiquidAppHealthWatchdog(*liquidAppName, liquidAppWebPage, this);
+    connect(liquidAppHealthWatchdog, &LiquidAppHealthWatchdog::crashed, this, [this]() {
+        liquidAppConfig->setValue(LQD_CFG_KEY_NAME_WATCHDOG_CRASH_COUNT, liquidAppConfig->value(LQD_CFG_KEY_NAME_WATCHDOG_CRASH_COUNT, 0).toInt() + 1);
+        liquidAppConfig->sync();
+    });
+    connect(liquidAppHealthWatchdog, &LiquidAppHealthWatchdog::hung, this, [this]() {
+        liquidAppConfig->setValue(LQD_CFG_KEY_NAME_WATCHDOG_HANG_COUNT, liquidAppConfig->value(LQD_CFG_KEY_NAME_WATCHDOG_HANG_COUNT, 0).toInt() + 1);
+        liquidAppConfig->sync();
+    });
+
+    // Restore web view zoom level (gets re-applied once navigation commits, see constructor)
     if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ZOOM_LVL)) {
         attemptToSetZoomFactorTo(liquidAppConfig->value(LQD_CFG_KEY_NAME_ZOOM_LVL).toDouble());
-
-        // There's a bug in Qt, using QTimer seems to be the only solution
-        QTimer::singleShot(1000, [&](){
-            if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ZOOM_LVL)) {
-                attemptToSetZoomFactorTo(liquidAppConfig->value(LQD_CFG_KEY_NAME_ZOOM_LVL).toDouble());
-            }
-        });
     }
 
     // Lock for the app's window's geometry
@@ -622,40 +788,48 @@ void LiquidAppWindow::loadLiquidAppConfig(void)
         liquidAppWebProfile->setHttpUserAgent(liquidAppConfig->value(LQD_CFG_KEY_NAME_USER_AGENT).toString());
     }
 
-    // Additional user-defined CSS (does't require JavaScript enabled in order to work)
-    if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ADDITIONAL_CSS)) {
-        QString additionalCss = liquidAppConfig->value(LQD_CFG_KEY_NAME_ADDITIONAL_CSS).toString();
-        const QString js = QString("(()=>{"\
-                                       "const styleEl = document.createElement('style');"\
-                                       "const cssTextNode = document.createTextNode('%1');"\
-                                       "styleEl.appendChild(cssTextNode);"\
-                                       "document.head.appendChild(styleEl)"\
-                                   "})();").arg(additionalCss.replace("\n", " ").replace("'", "\\'"));
+    // Scripts come already put together (see LiquidAppLaunchSnapshot)
+    const LiquidAppLaunchSnapshot launchSnapshot = LiquidAppLaunchSnapshot::load(*liquidAppName);
+    launchSettingsAreFromSnapshot = !launchSnapshot.isFromSettingsFile;
+    launchSettingsLoadTime = launchSnapshot.loadTime;
+
+    // Additional user-defined CSS (does't require JavaScript enabled in order to work),
+    // goes in as soon as the document is created so that the first frame is already styled
+    if (!launchSnapshot.additionalCssScriptSource.isEmpty()) {
         QWebEngineScript script;
-        script.setInjectionPoint(QWebEngineScript::DocumentReady);
+        script.setInjectionPoint(QWebEngineScript::DocumentCreation);
         script.setRunsOnSubFrames(false);
-        script.setSourceCode(js);
+        script.setSourceCode(launchSnapshot.additionalCssScriptSource);
         script.setWorldId(QWebEngineScript::ApplicationWorld);
         liquidAppWebPage->scripts().insert(script);
     }
 
     // Additional user-defined JS (does't require JavaScript enabled in order to work)
-    if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ADDITIONAL_JS)) {
-        QString js = liquidAppConfig->value(LQD_CFG_KEY_NAME_ADDITIONAL_JS).toString();
+    if (!launchSnapshot.additionalJsScriptSource.isEmpty()) {
         QWebEngineScript script;
         script.setInjectionPoint(QWebEngineScript::DocumentReady);
         script.setRunsOnSubFrames(false);
-        script.setSourceCode(js);
+        script.setSourceCode(launchSnapshot.additionalJsScriptSource);
         script.setWorldId(QWebEngineScript::ApplicationWorld);
         liquidAppWebPage->scripts().insert(script);
     }
 
+    // Move icon embedded by older versions out of the config file and into the icon cache
+    if (LiquidAppIconCache::isDataUrl(liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toString())) {
+        const QString iconHash = LiquidAppIconCache::storeDataUrl(liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toString());
+        if (!iconHash.isEmpty()) {
+            liquidAppConfig->setValue(LQD_CFG_KEY_NAME_ICON, iconHash);
+            liquidAppConfig->sync();
+        }
+    }
+
 #if !defined(Q_OS_LINUX) // This doesn't work on X11
     // Set window icon
     if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ICON)) {
-        QPixmap pixmap;
-        pixmap.loadFromData(QByteArray::fromBase64(liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toByteArray().remove(0, 22)), "PNG");
-        window()->setWindowIcon(QIcon(pixmap));
+        const QIcon icon = LiquidAppIconCache::getIcon(liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toString());
+        if (!icon.isNull()) {
+            window()->setWindowIcon(icon);
+        }
     }
 #endif
 }
@@ -669,30 +843,86 @@ void LiquidAppWindow::loadStarted(void)
     updateWindowTitle(title());
 }
 
+void LiquidAppWindow::logLaunch(const qint64 firstPaintTime)
+{
+    // Times are in microseconds, all but SettingsLoadTime are counted from when window's construction began
+    Liquid::appendLogRecord(LQD_LAUNCH_LOG_NAME,
+                            QStringList() << "Time" << "LiquidApp" << "LaunchSnapshot" << "SettingsLoadTime"
+                                          << "ConfigApplied" << "NavigationStarted" << "WindowShown" << "UiReady" << "FirstPaint",
+                            QStringList() << QDateTime::currentDateTimeUtc().toString(Qt::ISODate)
+                                          << *liquidAppName
+                                          << ((launchSettingsAreFromSnapshot) ? "hit" : "miss")
+                                          << QString::number(launchSettingsLoadTime)
+                                          << QString::number(launchConfigAppliedTime)
+                                          << QString::number(launchNavigationStartedTime)
+                                          << QString::number(launchWindowShownTime)
+                                          << QString::number(launchUiReadyTime)
+                                          << QString::number(firstPaintTime));
+}
+
 void LiquidAppWindow::moveEvent(QMoveEvent *event)
 {
     // Remember window position
-    liquidAppWindowGeometry = saveGeometry();
+    if (windowGeometryTimer) {
+        windowGeometryTimer->start();
+    }
 
     QWebEngineView::moveEvent(event);
 }
 
 void LiquidAppWindow::onIconChanged(QIcon icon)
 {
+    // Same icon as last time, nothing to encode or hash
+    if (icon.cacheKey() == iconCacheKey) {
+        return;
+    }
+    iconCacheKey = icon.cacheKey();
+
     // Set window icon
     setWindowIcon(icon);
 
-    iconToSave = icon;
+    // Only gets encoded and written to disk if it's an icon the cache hasn't seen before
+    const QString iconHash = LiquidAppIconCache::storeIcon(icon);
+    if (!iconHash.isEmpty()) {
+        iconHashToSave = iconHash;
+    }
+}
+
+QImage LiquidAppWindow::renderToImage(const QSize size)
+{
+    const int ratio = QPaintDevice::devicePixelRatio();
+
+    QImage image(size * ratio, QImage::Format_ARGB32);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    // TODO: make fonts appear less blurry (potentially use painter.scale(ratio, ratio)
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    painter.setRenderHint(QPainter::HighQualityAntialiasing);
+    painter.setRenderHint(QPainter::NonCosmeticDefaultPen);
+#endif
+
+    // Render contents of QWidget into QPainter
+    render(&painter);
+    painter.end();
+
+    return image;
 }
 
 void LiquidAppWindow::resizeEvent(QResizeEvent* event)
 {
     // Remember window size (unless in full-screen mode)
-    if (event->spontaneous() && !isFullScreen()) {
-        // Pause here to wait for any kind of window resize animations to finish
-        Liquid::sleep(200);
+    if (event->spontaneous() && !isFullScreen() && windowGeometryTimer) {
+        windowGeometryTimer->start();
+    }
 
-        liquidAppWindowGeometry = saveGeometry();
+    // Keep the splash covering the whole web view
+    if (splash) {
+        splash->setGeometry(contentsRect());
     }
 
     QWebEngineView::resizeEvent(event);
@@ -716,12 +946,20 @@ void LiquidAppWindow::saveLiquidAppConfig(void)
         }
     }
 
-    // Save icon data as base64 string
-    if (!iconToSave.isNull()) {
-        QBuffer buffer;
-        buffer.open(QIODevice::WriteOnly);
-        iconToSave.pixmap(iconToSave.availableSizes()[0]).save(&buffer, "PNG");
-        liquidAppConfig->setValue(LQD_CFG_KEY_NAME_ICON, QString("data:image/png;base64,%1").arg(QString(buffer.data().toBase64())));
+    // Save reference to the icon within the icon cache
+    if (!iconHashToSave.isEmpty() && liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toString() != iconHashToSave) {
+        const QString previousIconHash = liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toString();
+
+        liquidAppConfig->setValue(LQD_CFG_KEY_NAME_ICON, iconHashToSave);
+
+        // The icon it used to have may no longer be needed by anyone
+        LiquidAppIconCache::removeIconUnlessInUse(previousIconHash, *liquidAppName);
+    }
+
+    // Don't lose the very last move or resize
+    if (windowGeometryTimer->isActive()) {
+        windowGeometryTimer->stop();
+        snapshotWindowGeometry();
     }
 
     if (!isFullScreen()) {
@@ -739,6 +977,48 @@ void LiquidAppWindow::saveLiquidAppConfig(void)
     liquidAppConfig->sync();
 }
 
+void LiquidAppWindow::saveSplash(void)
+{
+    // The picture gets stored unencrypted, it's up to the user whether that's fine for this Liquid app
+    if (!liquidAppConfig->value(LQD_CFG_KEY_NAME_SHOW_SPLASH, false).toBool()) {
+        return;
+    }
+
+    // Only a fully loaded web page that's actually on screen is worth showing
+    if (!isVisible() || isMinimized() || isFullScreen() || splash || !startingUrlIsLoaded || pageIsLoading || pageHasError) {
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    // Frozen and discarded web pages have nothing to render
+    if (liquidAppWebPage->lifecycleState() != QWebEnginePage::LifecycleState::Active) {
+        return;
+    }
+#endif
+
+    const QSize splashSize = contentsRect().size() * LQD_SPLASH_SCALE;
+    const QImage splashImage = renderToImage(contentsRect().size())
+                                   .scaled(splashSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    const QString splashFilePath = getSplashFilePath(*liquidAppName);
+
+    QDir().mkpath(QFileInfo(splashFilePath).absolutePath());
+
+    QSaveFile splashFile(splashFilePath);
+    if (!splashFile.open(QIODevice::WriteOnly) || !splashImage.save(&splashFile, "PNG") || !splashFile.commit()) {
+        qDebug().noquote() << QString("Unable to save splash image %1").arg(splashFilePath);
+    }
+}
+
+void LiquidAppWindow::snapshotWindowGeometry(void)
+{
+    // Full-screen and minimized windows aren't what the window should be restored as
+    if (isFullScreen() || isMinimized()) {
+        return;
+    }
+
+    liquidAppWindowGeometry = saveGeometry();
+}
+
 void LiquidAppWindow::setupContextMenu(void)
 {
     contextMenu = new QMenu;
@@ -771,6 +1051,59 @@ void LiquidAppWindow::setForgiveNextPageLoadError(const bool ok)
     forgiveNextPageLoadError = ok;
 }
 
+void LiquidAppWindow::showSplash(void)
+{
+    const QString splashFilePath = getSplashFilePath(*liquidAppName);
+
+    // Get rid of whatever got saved before the splash got turned off
+    if (!liquidAppConfig->value(LQD_CFG_KEY_NAME_SHOW_SPLASH, false).toBool()) {
+        if (QFile::exists(splashFilePath) && !Liquid::shredFile(splashFilePath)) {
+            qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(splashFilePath);
+        }
+        return;
+    }
+
+    const QPixmap splashPixmap(splashFilePath);
+
+    if (splashPixmap.isNull()) {
+        return;
+    }
+
+    splash = new QLabel(this);
+    splash->setPixmap(splashPixmap);
+    splash->setScaledContents(true);
+    splash->setGeometry(contentsRect());
+    // It's only a picture, input is for the web page underneath
+    splash->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    splash->raise();
+
+    // Ask Chromium whether the web page got painted yet
+    splashTimer = new QTimer(this);
+    splashTimer->setInterval(LQD_SPLASH_POLL_INTERVAL);
+    connect(splashTimer, &QTimer::timeout, this, [this]() {
+        if (splashPaintCheckIsPending) {
+            return;
+        }
+
+        splashPaintCheckIsPending = true;
+
+        QPointer<LiquidAppWindow> window(this);
+        liquidAppWebPage->runJavaScript("performance.getEntriesByType('paint').length > 0",
+                                        QWebEngineScript::ApplicationWorld,
+                                        [window](const QVariant& result) {
+            if (!window) {
+                return;
+            }
+
+            window->splashPaintCheckIsPending = false;
+
+            if (result.toBool()) {
+                window->hideSplash();
+            }
+        });
+    });
+}
+
 void LiquidAppWindow::stopLoadingOrExitFullScreenMode(void)
 {
     if (pageIsLoading) {
@@ -835,20 +1168,7 @@ void LiquidAppWindow::takeSnapshot(const bool fullPage)
             }
         });
     } else {
-        const QImage::Format format = QImage::Format_ARGB32;
-        QImage* image = new QImage(snapshotSize * ratio, format);
-        image->setDevicePixelRatio(ratio);
-        image->fill(Qt::transparent);
-
-        QPainter* painter = new QPainter(image);
-        // TODO: make fonts appear less blurry (potentially use painter->scale(ratio, ratio)
-        painter->setRenderHint(QPainter::Antialiasing);
-        painter->setRenderHint(QPainter::TextAntialiasing);
-        painter->setRenderHint(QPainter::SmoothPixmapTransform);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-        painter->setRenderHint(QPainter::HighQualityAntialiasing);
-        painter->setRenderHint(QPainter::NonCosmeticDefaultPen);
-#endif
+        QImage image;
 
         if (fullPage) {
             const QSize origWindowSize = size();
@@ -864,8 +1184,8 @@ void LiquidAppWindow::takeSnapshot(const bool fullPage)
                 resize(snapshotSize);
             }
 
-            // Render contents of QWidget into QPainter
-            render(painter);
+            // Render contents of QWidget into an image
+            image = renderToImage(snapshotSize);
 
             // Restore the window back to be exactly how it was
             {
@@ -908,8 +1228,8 @@ void LiquidAppWindow::takeSnapshot(const bool fullPage)
             }
 #endif
 
-            // Render contents of QWidget into QPainter
-            render(painter);
+            // Render contents of QWidget into an image
+            image = renderToImage(snapshotSize);
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
             if (hadScrollBarsShown) {
@@ -919,16 +1239,11 @@ void LiquidAppWindow::takeSnapshot(const bool fullPage)
 #endif
         }
 
-        painter->end();
-        delete painter;
-
         // Save raster image to disk
-        image->scaled(snapshotSize.width(), snapshotSize.height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
-                .save(path + QDir::separator() + fileName + ".png", "PNG");
+        image.scaled(snapshotSize.width(), snapshotSize.height(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+             .save(path + QDir::separator() + fileName + ".png", "PNG");
 
         // TODO: add EXIF?
-
-        delete image;
     }
 
     // TODO: add camera flash visual effect
@@ -985,7 +1300,7 @@ void LiquidAppWindow::updateWindowTitle(const QString title)
     }
 
     // Append unicode icons
-    if (pageHasCertificateError) {
+    if (pageHasCertificateError || (liquidAppMemoryWatchdog && liquidAppMemoryWatchdog->isOverSoftLimit())) {
         textIcons.append(LQD_ICON_WARNING);
     }
     if (windowGeometryIsLocked) {
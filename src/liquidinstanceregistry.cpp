@@ -0,0 +1,235 @@
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QHash>
+#include <QSettings>
+
+#include "liquid.hpp"
+#include "liquidinstanceregistry.hpp"
+#include "lqd.h"
+
+/*
+ * Every running Liquid app publishes a small record about itself within the runtime directory,
+ * and keeps it up to date with how much memory and CPU it uses.
+ * That's what lets anyone (liquid --status, the main window) see what's running
+ * without having to ask every Liquid app separately.
+ *
+ * Records are removed by Liquid apps as they quit; ones left behind by processes
+ * that didn't quit properly stop getting updated, and get removed by whoever comes across them.
+ *
+ * All Liquid apps within the same process (see LiquidAppHost) get updated at once,
+ * the process itself gets measured only once for all of them, and is accounted for in only one record.
+ * This runs on the GUI thread of every Liquid app, so only the process itself and its renderer get measured,
+ * using resident set size (cheap to get) rather than walking the whole process tree or every memory mapping.
+ */
+static const char* recordKeyName = "Name";
+static const char* recordKeyProcessId = "ProcessID";
+static const char* recordKeyRenderProcessId = "RenderProcessID";
+static const char* recordKeyStartTime = "StartTime";
+static const char* recordKeyMemoryUsage = "MemoryUsage";
+static const char* recordKeyCpuUsage = "CPUUsage";
+static const char* recordKeyRenderProcessMemoryUsage = "RenderProcessMemoryUsage";
+static const char* recordKeyRenderProcessCpuUsage = "RenderProcessCPUUsage";
+static const char* recordKeyUpdateTime = "UpdateTime";
+
+// Liquid apps running within this process
+static QList<LiquidInstanceRegistry*> instanceRegistries;
+static QTimer* updateTimer = Q_NULLPTR;
+
+// The process itself, as of the last update
+static qint64 processMemoryUsage = -1;
+static qreal processCpuUsage = -1;
+static QElapsedTimer processUpdateElapsedTimer;
+static qint64 lastProcessCpuTime = -1;
+
+// Record file path -> its modification time and what got parsed out of it
+static QHash<QString, QPair<QDateTime, LiquidInstanceRegistry::Record>> parsedRecords;
+
+LiquidInstanceRegistry::LiquidInstanceRegistry(const QString liquidAppName, QWebEnginePage* page, QObject* parent) : QObject(parent)
+{
+    this->page = page;
+
+    record.liquidAppName = liquidAppName;
+    record.processId = QCoreApplication::applicationPid();
+    record.startTime = QDateTime::currentDateTimeUtc();
+
+    // Several Liquid apps may share the same process (see LiquidAppHost)
+    recordFilePath = getRegistryDir().absolutePath() + QDir::separator()
+                   + QString("%1-%2.ini")
+                       .arg(record.processId)
+                       .arg(QString(QCryptographicHash::hash(liquidAppName.toUtf8(), QCryptographicHash::Md5).toHex()));
+
+    QDir().mkpath(getRegistryDir().absolutePath());
+
+    instanceRegistries << this;
+
+    if (!updateTimer) {
+        updateTimer = new QTimer(QCoreApplication::instance());
+        updateTimer->setInterval(LQD_INSTANCE_STATS_INTERVAL);
+        QObject::connect(updateTimer, &QTimer::timeout, &LiquidInstanceRegistry::updateAll);
+    }
+
+    if (updateTimer->isActive()) {
+        // Whole process got measured not too long ago
+        update();
+    } else {
+        updateTimer->start();
+        updateAll();
+    }
+}
+
+LiquidInstanceRegistry::~LiquidInstanceRegistry(void)
+{
+    instanceRegistries.removeAll(this);
+
+    if (instanceRegistries.isEmpty()) {
+        updateTimer->stop();
+    }
+
+    QFile::remove(recordFilePath);
+}
+
+qreal LiquidInstanceRegistry::getCpuUsage(const qint64 cpuTime, const qint64 lastCpuTime, const qint64 elapsed)
+{
+    if (cpuTime < 0 || lastCpuTime < 0 || elapsed <= 0) {
+        return -1;
+    }
+
+    // Percent of a single CPU core, same as top does it
+    return (cpuTime - lastCpuTime) * 100.0 / elapsed;
+}
+
+QList<LiquidInstanceRegistry::Record> LiquidInstanceRegistry::getRecords(void)
+{
+    QList<Record> records;
+
+    const QFileInfoList recordFileList = getRegistryDir().entryInfoList(QStringList() << "*.ini", QDir::Files, QDir::Name);
+    QHash<QString, QPair<QDateTime, Record>> currentParsedRecords;
+
+    foreach (const QFileInfo recordFileInfo, recordFileList) {
+        const QString recordFilePath = recordFileInfo.absoluteFilePath();
+        const QDateTime recordFileModificationTime = recordFileInfo.lastModified();
+
+        // Files that haven't been written since the last time don't need to be parsed again
+        if (parsedRecords.contains(recordFilePath) && parsedRecords.value(recordFilePath).first == recordFileModificationTime) {
+            currentParsedRecords.insert(recordFilePath, parsedRecords.value(recordFilePath));
+        } else {
+            const QSettings recordFile(recordFilePath, QSettings::IniFormat);
+
+            Record record;
+            record.liquidAppName = recordFile.value(recordKeyName).toString();
+            record.processId = recordFile.value(recordKeyProcessId, -1).toLongLong();
+            record.renderProcessId = recordFile.value(recordKeyRenderProcessId, -1).toLongLong();
+            record.startTime = recordFile.value(recordKeyStartTime).toDateTime();
+            record.memoryUsage = recordFile.value(recordKeyMemoryUsage, -1).toLongLong();
+            record.cpuUsage = recordFile.value(recordKeyCpuUsage, -1).toDouble();
+            record.renderProcessMemoryUsage = recordFile.value(recordKeyRenderProcessMemoryUsage, -1).toLongLong();
+            record.renderProcessCpuUsage = recordFile.value(recordKeyRenderProcessCpuUsage, -1).toDouble();
+            record.updateTime = recordFile.value(recordKeyUpdateTime).toDateTime();
+            currentParsedRecords.insert(recordFilePath, qMakePair(recordFileModificationTime, record));
+        }
+
+        const Record record = currentParsedRecords.value(recordFilePath).second;
+
+        bool isStale = !record.updateTime.isValid() || record.updateTime.msecsTo(QDateTime::currentDateTimeUtc()) > LQD_INSTANCE_STATS_INTERVAL * 3;
+#if defined(Q_OS_LINUX)
+        isStale = isStale || !QFileInfo::exists(QString("/proc/%1").arg(record.processId));
+#endif
+
+        // Left behind by a process that didn't quit properly
+        if (isStale) {
+            QFile::remove(recordFilePath);
+            currentParsedRecords.remove(recordFilePath);
+            continue;
+        }
+
+        records << record;
+    }
+
+    // Records that are gone don't need to be remembered
+    parsedRecords = currentParsedRecords;
+
+    return records;
+}
+
+QDir LiquidInstanceRegistry::getRegistryDir(void)
+{
+    return QDir(Liquid::getRuntimeDir().absolutePath() + QDir::separator() + LQD_INSTANCES_DIR_NAME + QDir::separator());
+}
+
+void LiquidInstanceRegistry::update(void)
+{
+    const qint64 elapsed = (updateElapsedTimer.isValid()) ? updateElapsedTimer.restart() : -1;
+    if (!updateElapsedTimer.isValid()) {
+        updateElapsedTimer.start();
+    }
+
+    // Whole process, accounted for only once
+    {
+        const bool isAccountableForProcess = !instanceRegistries.isEmpty() && instanceRegistries.first() == this;
+
+        record.memoryUsage = (isAccountableForProcess) ? processMemoryUsage : -1;
+        record.cpuUsage = (isAccountableForProcess) ? processCpuUsage : -1;
+    }
+
+    // Renderer process
+    {
+        qint64 renderProcessId = -1;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+        renderProcessId = page->renderProcessPid();
+#endif
+
+        // May get replaced (e.g. after a crash)
+        if (renderProcessId != record.renderProcessId) {
+            record.renderProcessId = renderProcessId;
+            lastRenderProcessCpuTime = -1;
+        }
+
+        if (renderProcessId > 0) {
+            const qint64 renderProcessCpuTime = Liquid::getProcessCpuTime(renderProcessId);
+
+            record.renderProcessMemoryUsage = Liquid::getProcessResidentSetSize(renderProcessId);
+            record.renderProcessCpuUsage = getCpuUsage(renderProcessCpuTime, lastRenderProcessCpuTime, elapsed);
+            lastRenderProcessCpuTime = renderProcessCpuTime;
+        } else {
+            record.renderProcessMemoryUsage = -1;
+            record.renderProcessCpuUsage = -1;
+        }
+    }
+
+    record.updateTime = QDateTime::currentDateTimeUtc();
+
+    QSettings recordFile(recordFilePath, QSettings::IniFormat);
+    recordFile.setValue(recordKeyName, record.liquidAppName);
+    recordFile.setValue(recordKeyProcessId, record.processId);
+    recordFile.setValue(recordKeyRenderProcessId, record.renderProcessId);
+    recordFile.setValue(recordKeyStartTime, record.startTime);
+    recordFile.setValue(recordKeyMemoryUsage, record.memoryUsage);
+    recordFile.setValue(recordKeyCpuUsage, record.cpuUsage);
+    recordFile.setValue(recordKeyRenderProcessMemoryUsage, record.renderProcessMemoryUsage);
+    recordFile.setValue(recordKeyRenderProcessCpuUsage, record.renderProcessCpuUsage);
+    recordFile.setValue(recordKeyUpdateTime, record.updateTime);
+    recordFile.sync();
+}
+
+void LiquidInstanceRegistry::updateAll(void)
+{
+    const qint64 elapsed = (processUpdateElapsedTimer.isValid()) ? processUpdateElapsedTimer.restart() : -1;
+    if (!processUpdateElapsedTimer.isValid()) {
+        processUpdateElapsedTimer.start();
+    }
+
+    // The process itself, web engine's helper processes are left out
+    {
+        const qint64 processId = QCoreApplication::applicationPid();
+        const qint64 cpuTime = Liquid::getProcessCpuTime(processId);
+
+        processMemoryUsage = Liquid::getProcessResidentSetSize(processId);
+        processCpuUsage = getCpuUsage(cpuTime, lastProcessCpuTime, elapsed);
+        lastProcessCpuTime = cpuTime;
+    }
+
+    foreach (LiquidInstanceRegistry* instanceRegistry, instanceRegistries) {
+        instanceRegistry->update();
+    }
+}
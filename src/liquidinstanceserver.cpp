@@ -0,0 +1,104 @@
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include "liquid.hpp"
+#include "liquidinstanceserver.hpp"
+#include "lqd.h"
+
+/*
+ * Makes sure there's only one instance of the program's main window,
+ * as well as only one instance of every Liquid app (empty name stands for the former).
+ *
+ * The running instance listens on a local socket, and any later attempt to run it
+ * gets handed over to that instance instead of starting another one:
+ *   activate [URL]  (replied to with "ok")
+ * A socket left behind by an instance that didn't quit properly has nobody listening on it,
+ * which is how it gets told apart from one that's still in use.
+ */
+static const QByteArray requestActivate("activate");
+static const QByteArray replyOk("ok");
+
+LiquidInstanceServer::LiquidInstanceServer(const QString liquidAppName, QObject* parent) : QObject(parent)
+{
+    serverName = getServerName(liquidAppName);
+
+    server = new QLocalServer(this);
+    // Don't let other users bring up this user's windows
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &LiquidInstanceServer::onNewConnection);
+}
+
+QString LiquidInstanceServer::getServerName(const QString liquidAppName)
+{
+    if (liquidAppName.isEmpty()) {
+        return Liquid::getUserName() + "_Liquid";
+    }
+
+    // Liquid app names may be too long (or contain too many unusual characters) to be used as socket names as they are
+    return Liquid::getUserName() + "_Liquid_app_" + QCryptographicHash::hash(liquidAppName.toUtf8(), QCryptographicHash::Md5).toHex();
+}
+
+bool LiquidInstanceServer::listen(void)
+{
+    bool isAlreadyRunning = false;
+
+    if (!Liquid::listenOnLocalSocket(server, serverName, &isAlreadyRunning)) {
+        // Another instance being there already is what this is for, it's not an error
+        if (!isAlreadyRunning) {
+            qDebug().noquote() << QString("Unable to listen on local socket “%1”: %2").arg(serverName).arg(server->errorString());
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void LiquidInstanceServer::onNewConnection(void)
+{
+    while (server->hasPendingConnections()) {
+        QLocalSocket* socket = server->nextPendingConnection();
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            while (socket->canReadLine()) {
+                const QByteArray request = socket->readLine().trimmed();
+
+                if (request.startsWith(requestActivate)) {
+                    socket->write(replyOk + "\n");
+                    socket->flush();
+
+                    emit activationRequested(QUrl::fromEncoded(request.mid(requestActivate.size()).trimmed()));
+                }
+            }
+        });
+
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+bool LiquidInstanceServer::requestActivation(const QString liquidAppName, const QUrl url)
+{
+    QLocalSocket socket;
+
+    socket.connectToServer(getServerName(liquidAppName));
+    if (!socket.waitForConnected(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return false;
+    }
+
+    QByteArray request = requestActivate;
+    if (url.isValid()) {
+        request += " " + url.toEncoded();
+    }
+
+    socket.write(request + "\n");
+    if (!socket.waitForBytesWritten(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return false;
+    }
+
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(LQD_LAUNCHER_REPLY_TIMEOUT)) {
+            return false;
+        }
+    }
+
+    return socket.readLine().trimmed() == replyOk;
+}
@@ -0,0 +1,186 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QProcess>
+#include <QTimer>
+
+#include "liquid.hpp"
+#include "liquidlauncherdaemon.hpp"
+#include "lqd.h"
+
+/*
+ * The launcher daemon is an opt-in resident process (liquid --launcher-daemon)
+ * which keeps a pre-initialized Liquid process (liquid --standby) on hold,
+ * with QApplication constructed and the web engine already up and running.
+ * Requests to run a Liquid app get handed over to that process,
+ * and a fresh one gets started in the background right after.
+ * Every Liquid app still runs in its own process, with its own off-the-record profile.
+ *
+ * Requests are single lines sent over a local socket:
+ *   run <Liquid app name>  (from whoever wants a Liquid app to be run)
+ *   standby                (from a pre-initialized process ready to take over)
+ * The daemon replies "ok" to the former, and sends the Liquid app name to the latter.
+ */
+static const QByteArray requestRun("run ");
+static const QByteArray requestStandby("standby");
+static const QByteArray replyOk("ok");
+
+LiquidLauncherDaemon::LiquidLauncherDaemon(QObject* parent) : QObject(parent)
+{
+    server = new QLocalServer(this);
+    // Don't let other users hand anything over to this daemon
+    server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(server, &QLocalServer::newConnection, this, &LiquidLauncherDaemon::onNewConnection);
+}
+
+LiquidLauncherDaemon::~LiquidLauncherDaemon(void)
+{
+    // Processes on standby quit once the daemon is gone
+    foreach (QLocalSocket* standbySocket, standbySockets) {
+        standbySocket->disconnectFromServer();
+    }
+}
+
+QString LiquidLauncherDaemon::getServerName(void)
+{
+    return Liquid::getUserName() + "_Liquid_launcher";
+}
+
+void LiquidLauncherDaemon::handleRequest(QLocalSocket* socket, const QByteArray& request)
+{
+    if (request == requestStandby) {
+        isStandbyProcessStarting = false;
+        standbySockets.append(socket);
+    } else if (request.startsWith(requestRun)) {
+        launch(QString::fromUtf8(request.mid(requestRun.size())));
+        socket->write(replyOk + "\n");
+        socket->flush();
+    }
+}
+
+void LiquidLauncherDaemon::launch(const QString liquidAppName)
+{
+    // Processes on standby are started with engine flags common to all Liquid apps
+    if (standbySockets.size() > 0 && Liquid::getChromiumFlags(liquidAppName) == Liquid::getChromiumFlags()) {
+        QLocalSocket* standbySocket = standbySockets.takeFirst();
+        standbySocket->write(liquidAppName.toUtf8() + "\n");
+        standbySocket->flush();
+    } else {
+        // Nothing's warmed up yet (or it can't be used), fall back to starting it from scratch
+        QProcess::startDetached(QCoreApplication::applicationFilePath(), QStringList() << liquidAppName);
+    }
+
+    // Have another one ready for next time
+    spawnStandbyProcess();
+}
+
+bool LiquidLauncherDaemon::listen(void)
+{
+    bool isAlreadyRunning = false;
+
+    if (!Liquid::listenOnLocalSocket(server, getServerName(), &isAlreadyRunning)) {
+        if (isAlreadyRunning) {
+            qDebug().noquote() << QString("Liquid launcher daemon is already running");
+        } else {
+            qDebug().noquote() << QString("Unable to start Liquid launcher daemon: %1").arg(server->errorString());
+        }
+        return false;
+    }
+
+    spawnStandbyProcess();
+
+    return true;
+}
+
+void LiquidLauncherDaemon::onNewConnection(void)
+{
+    while (server->hasPendingConnections()) {
+        QLocalSocket* socket = server->nextPendingConnection();
+
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            while (socket->canReadLine()) {
+                handleRequest(socket, socket->readLine().trimmed());
+            }
+        });
+
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            // A process on standby is gone without being handed anything (crashed or got killed)
+            if (standbySockets.removeAll(socket) > 0) {
+                QTimer::singleShot(LQD_LAUNCHER_RESPAWN_DELAY, this, &LiquidLauncherDaemon::spawnStandbyProcess);
+            }
+
+            socket->deleteLater();
+        });
+    }
+}
+
+bool LiquidLauncherDaemon::requestLaunch(const QString liquidAppName)
+{
+    QLocalSocket socket;
+
+    socket.connectToServer(getServerName());
+    if (!socket.waitForConnected(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return false;
+    }
+
+    socket.write(requestRun + liquidAppName.toUtf8() + "\n");
+    if (!socket.waitForBytesWritten(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return false;
+    }
+
+    // Make sure the daemon has taken care of it
+    while (!socket.canReadLine()) {
+        if (!socket.waitForReadyRead(LQD_LAUNCHER_REPLY_TIMEOUT)) {
+            return false;
+        }
+    }
+
+    return socket.readLine().trimmed() == replyOk;
+}
+
+void LiquidLauncherDaemon::spawnStandbyProcess(void)
+{
+    if (isStandbyProcessStarting || standbySockets.size() > 0) {
+        return;
+    }
+
+    isStandbyProcessStarting = QProcess::startDetached(QCoreApplication::applicationFilePath(), QStringList() << "--standby");
+
+    // Don't wait forever for a process that may have failed to start up
+    QTimer::singleShot(LQD_LAUNCHER_STANDBY_TIMEOUT, this, [this]() {
+        if (isStandbyProcessStarting) {
+            isStandbyProcessStarting = false;
+            spawnStandbyProcess();
+        }
+    });
+}
+
+QString LiquidLauncherDaemon::waitForLaunchRequest(void)
+{
+    QLocalSocket socket;
+
+    socket.connectToServer(getServerName());
+    if (!socket.waitForConnected(LQD_LAUNCHER_CONNECT_TIMEOUT)) {
+        return QString();
+    }
+
+    socket.write(requestStandby + "\n");
+    socket.flush();
+
+    // Keep the event loop running (the web engine needs it) until told which Liquid app to become,
+    // or until the daemon goes away
+    QEventLoop eventLoop;
+    connect(&socket, &QLocalSocket::readyRead, &eventLoop, [&socket, &eventLoop]() {
+        if (socket.canReadLine()) {
+            eventLoop.quit();
+        }
+    });
+    connect(&socket, &QLocalSocket::disconnected, &eventLoop, &QEventLoop::quit);
+    eventLoop.exec();
+
+    if (!socket.canReadLine()) {
+        return QString();
+    }
+
+    return QString::fromUtf8(socket.readLine()).trimmed();
+}
@@ -0,0 +1,251 @@
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QSysInfo>
+#include <QThread>
+#include <QTimer>
+
+#include "liquid.hpp"
+#include "liquidrenderingbackend.hpp"
+#include "liquidsettings.hpp"
+#include "lqd.h"
+
+/*
+ * Decides whether the web engine should make use of the GPU, or go with software rasterization.
+ * Forcing GPU rasterization and compositing on machines that have no usable GPU (thin clients, VMs)
+ * makes Chromium fall back on its own, which is both slow and poorly tuned.
+ *
+ * Web engine flags have to be in place before QApplication gets constructed, while asking OpenGL
+ * what it renders with needs one; so the outcome of a proper check gets cached per machine,
+ * and only a quick look at available GPU devices gets done when there's nothing cached yet.
+ * Setting LIQUID_RENDERING to "gpu" or "software" overrides all of that.
+ *
+ * The proper check runs in a separate process (see LQD_RENDERING_PROBE_FLAG): it keeps the GUI responsive,
+ * isn't affected by whichever OpenGL implementation the asking process was told to use,
+ * and a GPU driver that crashes or hangs there only takes the probe down with it.
+ * It gets done again once Qt, the kernel (along with its GPU drivers) or GPU devices change.
+ */
+static int gpuUsable = -1;
+
+static const char* softwareRenderers[] = {
+    "llvmpipe",
+    "softpipe",
+    "swrast",
+    "SwiftShader",
+    "Software Rasterizer",
+    "Basic Render Driver",
+    "GDI Generic",
+};
+
+void LiquidRenderingBackend::detect(void)
+{
+    QProcess* probeProcess = startProbe(QCoreApplication::instance());
+
+    // A GPU driver that hangs is no better than no GPU at all
+    QTimer::singleShot(LQD_RENDERING_PROBE_TIMEOUT, probeProcess, [probeProcess]() {
+        probeProcess->kill();
+    });
+
+    QObject::connect(probeProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), probeProcess, [probeProcess]() {
+        storeProbeResult(probeProcess);
+        probeProcess->deleteLater();
+    });
+    QObject::connect(probeProcess, &QProcess::errorOccurred, probeProcess, [probeProcess](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            storeProbeResult(probeProcess);
+            probeProcess->deleteLater();
+        }
+    });
+}
+
+void LiquidRenderingBackend::detectUnlessKnown(void)
+{
+    // One probe per process is plenty
+    static bool isDetectionStarted = false;
+    if (isDetectionStarted) {
+        return;
+    }
+
+    const QString machineGroupName = getMachineGroupName();
+    LiquidSettings* settings = LiquidSettings::forProgram();
+
+    // Whatever was detected still holds, unless something it depends on has changed since (e.g. drivers got updated)
+    if (settings->contains(machineGroupName + "/" + LQD_CFG_KEY_NAME_RENDERING_USE_GPU)
+        && settings->value(machineGroupName + "/" + LQD_CFG_KEY_NAME_RENDERING_ENVIRONMENT).toString() == getEnvironment()
+    ) {
+        return;
+    }
+
+    isDetectionStarted = true;
+    detect();
+}
+
+QStringList LiquidRenderingBackend::getDiagnostics(void)
+{
+    QStringList lines;
+
+    QProcess* probeProcess = startProbe();
+    probeProcess->waitForFinished(LQD_RENDERING_PROBE_TIMEOUT);
+    const QString glRenderer = storeProbeResult(probeProcess);
+    delete probeProcess;
+
+    const QString renderingOverride = QString(qgetenv(LQD_ENV_VAR_RENDERING)).toLower();
+
+    // Make sure what's shown below is based on what's just been detected
+    gpuUsable = -1;
+
+    lines << QString("Machine: %1").arg(QSysInfo::machineHostName());
+    lines << QString("CPU threads: %1").arg(QThread::idealThreadCount());
+    lines << QString("OpenGL renderer: %1").arg((glRenderer.isEmpty()) ? "unavailable" : glRenderer);
+    lines << QString("Rendering backend: %1%2")
+                .arg((isGpuUsable()) ? "GPU" : "software")
+                .arg((renderingOverride.isEmpty()) ? "" : QString(" (set by %1)").arg(LQD_ENV_VAR_RENDERING));
+    lines << QString("Raster threads: %1").arg(getRasterThreadCount(isGpuUsable()));
+    lines << QString("Chromium flags: %1").arg(Liquid::getChromiumFlags().join(" "));
+
+    return lines;
+}
+
+QString LiquidRenderingBackend::getEnvironment(void)
+{
+    return (QStringList() << qVersion() << QSysInfo::kernelVersion() << getGpuDevices().join(",")).join(" ");
+}
+
+QString LiquidRenderingBackend::getGlRenderer(void)
+{
+    QString glRenderer;
+
+    QOffscreenSurface surface;
+    surface.create();
+
+    QOpenGLContext context;
+    if (context.create() && context.makeCurrent(&surface)) {
+        glRenderer = QString(reinterpret_cast<const char*>(context.functions()->glGetString(GL_RENDERER)));
+        context.doneCurrent();
+    }
+
+    return glRenderer;
+}
+
+QStringList LiquidRenderingBackend::getGpuDevices(void)
+{
+#if defined(Q_OS_LINUX)
+    // DRM devices are what Mesa (and therefore Chromium) renders with
+    return QDir("/dev/dri").entryList(QStringList() << "card*" << "renderD*", QDir::AllEntries | QDir::System);
+#else
+    return QStringList();
+#endif
+}
+
+QString LiquidRenderingBackend::getMachineGroupName(void)
+{
+    // Program settings may be shared across machines (e.g. roaming home directories), GPUs aren't
+    QString machineName = QSysInfo::machineHostName();
+
+    if (machineName.isEmpty()) {
+        machineName = "localhost";
+    }
+
+    return QString(LQD_CFG_GROUP_NAME_RENDERING) + "/" + machineName;
+}
+
+int LiquidRenderingBackend::getRasterThreadCount(const bool isGpuUsable)
+{
+    // Chromium doesn't go over 4 anyway
+    if (isGpuUsable) {
+        return qBound(1, QThread::idealThreadCount(), 4);
+    }
+
+    // Rasterizing in software is what keeps the CPU busy, yet one core is better left to everything else
+    return qBound(1, QThread::idealThreadCount() - 1, 4);
+}
+
+bool LiquidRenderingBackend::isGpuUsable(void)
+{
+    if (gpuUsable > -1) {
+        return gpuUsable;
+    }
+
+    const QString renderingOverride = QString(qgetenv(LQD_ENV_VAR_RENDERING)).toLower();
+    if (!renderingOverride.isEmpty()) {
+        gpuUsable = (renderingOverride == "gpu");
+        return gpuUsable;
+    }
+
+    gpuUsable = LiquidSettings::forProgram()->value(getMachineGroupName() + "/" + LQD_CFG_KEY_NAME_RENDERING_USE_GPU, probeGpuDevices()).toBool();
+
+    return gpuUsable;
+}
+
+bool LiquidRenderingBackend::isSoftwareRenderer(const QString glRenderer)
+{
+    for (const char* softwareRenderer : softwareRenderers) {
+        if (glRenderer.contains(softwareRenderer, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool LiquidRenderingBackend::probeGpuDevices(void)
+{
+#if defined(Q_OS_LINUX)
+    if (qgetenv("LIBGL_ALWAYS_SOFTWARE") == "1") {
+        return false;
+    }
+
+    return getGpuDevices().size() > 0;
+#else
+    // No cheap way to tell, the proper check will have the final say
+    return true;
+#endif
+}
+
+QProcess* LiquidRenderingBackend::startProbe(QObject* parent)
+{
+    QProcess* probeProcess = new QProcess(parent);
+
+    probeProcess->start(QCoreApplication::applicationFilePath(), QStringList() << LQD_RENDERING_PROBE_FLAG);
+
+    return probeProcess;
+}
+
+QString LiquidRenderingBackend::storeProbeResult(QProcess* probeProcess)
+{
+    if (probeProcess->error() == QProcess::FailedToStart) {
+        qDebug().noquote() << QString("Unable to start %1 to detect rendering backend").arg(probeProcess->program());
+        return QString();
+    }
+
+    if (probeProcess->state() != QProcess::NotRunning) {
+        probeProcess->kill();
+        probeProcess->waitForFinished();
+    }
+
+    // Having crashed or hung while talking to OpenGL means the GPU's driver isn't to be relied on
+    const bool probeSucceeded = probeProcess->exitStatus() == QProcess::NormalExit && probeProcess->exitCode() == EXIT_SUCCESS;
+    const QString glRenderer = (probeSucceeded) ? QString::fromUtf8(probeProcess->readAllStandardOutput()).trimmed() : QString();
+
+    // Not being able to create a context says little about the GPU itself (e.g. no OpenGL ES support), see what devices there are
+    const bool isGpuUsable = probeSucceeded && ((glRenderer.isEmpty()) ? probeGpuDevices() : !isSoftwareRenderer(glRenderer));
+
+    LiquidSettings* settings = LiquidSettings::forProgram();
+    settings->beginGroup(getMachineGroupName());
+    settings->setValue(LQD_CFG_KEY_NAME_RENDERING_USE_GPU, isGpuUsable);
+    settings->setValue(LQD_CFG_KEY_NAME_RENDERING_GL_RENDERER, glRenderer);
+    settings->setValue(LQD_CFG_KEY_NAME_RENDERING_DETECTED_AT, QDateTime::currentDateTimeUtc());
+    settings->setValue(LQD_CFG_KEY_NAME_RENDERING_ENVIRONMENT, getEnvironment());
+    settings->endGroup();
+    settings->sync();
+
+    if (gpuUsable > -1 && gpuUsable != isGpuUsable && qgetenv(LQD_ENV_VAR_RENDERING).isEmpty()) {
+        qDebug().noquote() << QString("Switching to %1 rendering, takes effect next time Liquid apps get started").arg((isGpuUsable) ? "GPU" : "software");
+    }
+
+    return glRenderer;
+}
@@ -0,0 +1,359 @@
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "liquid.hpp"
+#include "liquidapplaunchsnapshot.hpp"
+#include "liquidsettings.hpp"
+#include "lqd.h"
+
+/*
+ * One parsed copy of each settings file per process, shared by everyone who needs it
+ * (web engine flags, Liquid app's window, its config dialog, etc).
+ *
+ * Values are served from memory; changes get collected for a short while
+ * and then written out by a background thread, so that the GUI never waits on the disk.
+ * Only the keys that have changed get written, on top of whatever is in the file at that point,
+ * and QSettings replaces the file atomically while doing so.
+ *
+ * Settings files of Liquid apps may get changed by other processes,
+ * those get parsed again (off the GUI thread) after having been modified on disk.
+ * Files written by this very process are told apart by the modification time the background thread left them with.
+ * Liquid apps' settings come out of their launch snapshots (see LiquidAppLaunchSnapshot),
+ * which get made anew every time their settings files are written.
+ */
+static QHash<QString, LiquidSettings*> liquidAppSettings;
+static LiquidSettings* programSettings = Q_NULLPTR;
+static QThreadPool* flushThreadPool = Q_NULLPTR;
+
+// Settings file name -> its modification time right after the background thread last wrote into it
+static QHash<QString, QDateTime> writtenFileModificationTimes;
+static QMutex writtenFileModificationTimesMutex;
+
+static QThreadPool* getFlushThreadPool(void)
+{
+    if (!flushThreadPool) {
+        // A single thread keeps writes to the same file in order
+        flushThreadPool = new QThreadPool;
+        flushThreadPool->setMaxThreadCount(1);
+
+        // Make sure everything is on disk before the program quits
+        qAddPostRoutine(LiquidSettings::waitForFlush);
+    }
+
+    return flushThreadPool;
+}
+
+LiquidSettings::LiquidSettings(const QString fileName, const QSettings::Format format, const QString liquidAppName) : QObject()
+{
+    this->liquidAppName = liquidAppName;
+    settingsFileName = fileName;
+    settingsFormat = format;
+
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(LQD_SETTINGS_FLUSH_DELAY);
+    connect(flushTimer, &QTimer::timeout, this, &LiquidSettings::flush);
+}
+
+QStringList LiquidSettings::allKeys(void) const
+{
+    const QString prefix = getFullKey(QString());
+    QStringList keys;
+
+    for (QHash<QString, QVariant>::const_iterator it = values.constBegin(); it != values.constEnd(); ++it) {
+        if (it.key().startsWith(prefix)) {
+            keys << it.key().mid(prefix.size());
+        }
+    }
+
+    return keys;
+}
+
+void LiquidSettings::beginGroup(const QString prefix)
+{
+    groups << prefix;
+}
+
+bool LiquidSettings::contains(const QString key) const
+{
+    return values.contains(getFullKey(key));
+}
+
+void LiquidSettings::endGroup(void)
+{
+    if (!groups.isEmpty()) {
+        groups.removeLast();
+    }
+}
+
+QString LiquidSettings::fileName(void) const
+{
+    return settingsFileName;
+}
+
+void LiquidSettings::flush(void)
+{
+    flushTimer->stop();
+
+    if (!hasPendingChanges()) {
+        return;
+    }
+
+    QtConcurrent::run(getFlushThreadPool(), &LiquidSettings::writeToDisk, settingsFileName, settingsFormat, liquidAppName, removedKeys, changedValues);
+
+    removedKeys.clear();
+    changedValues.clear();
+}
+
+LiquidSettings* LiquidSettings::forLiquidApp(const QString liquidAppName)
+{
+    LiquidSettings* settings = liquidAppSettings.value(liquidAppName, Q_NULLPTR);
+
+    if (!settings) {
+        // Spares having to parse the settings file, unless it's changed since the snapshot was made
+        const LiquidAppLaunchSnapshot launchSnapshot = LiquidAppLaunchSnapshot::load(liquidAppName);
+
+        settings = new LiquidSettings(getLiquidAppFilePath(liquidAppName), QSettings::IniFormat, liquidAppName);
+        settings->values = launchSnapshot.values;
+        settings->parsedFileModificationTime = launchSnapshot.settingsFileModificationTime;
+        liquidAppSettings.insert(liquidAppName, settings);
+    } else if (!settings->hasPendingChanges() && settings->isModifiedElsewhere()) {
+        // Changed by some other process (e.g. Liquid app's config dialog), and whoever asks needs it current right away;
+        // the launch snapshot that process has made along with it is a lot quicker to read than the settings file
+        const LiquidAppLaunchSnapshot launchSnapshot = LiquidAppLaunchSnapshot::load(liquidAppName);
+
+        settings->values = launchSnapshot.values;
+        settings->parsedFileModificationTime = launchSnapshot.settingsFileModificationTime;
+    }
+
+    return settings;
+}
+
+LiquidSettings* LiquidSettings::forProgram(void)
+{
+    if (!programSettings) {
+        const QSettings settings(PROG_NAME, PROG_NAME);
+
+        programSettings = new LiquidSettings(settings.fileName(), settings.format());
+        programSettings->parse(settings);
+    }
+
+    return programSettings;
+}
+
+void LiquidSettings::forgetLiquidApp(const QString liquidAppName)
+{
+    // Nothing should get written into the file after it's gone
+    LiquidSettings* settings = liquidAppSettings.take(liquidAppName);
+    if (settings) {
+        settings->removedKeys.clear();
+        settings->changedValues.clear();
+        delete settings;
+    }
+
+    waitForFlush();
+}
+
+QString LiquidSettings::getLiquidAppFilePath(const QString liquidAppName)
+{
+    return Liquid::getAppsDir().absoluteFilePath(liquidAppName + ".ini");
+}
+
+QDateTime LiquidSettings::getFileModificationTime(void) const
+{
+    const QFileInfo fileInfo(settingsFileName);
+
+    return (fileInfo.exists()) ? fileInfo.lastModified() : QDateTime();
+}
+
+QString LiquidSettings::getFullKey(const QString key) const
+{
+    if (groups.isEmpty()) {
+        return key;
+    }
+
+    return groups.join("/") + "/" + key;
+}
+
+bool LiquidSettings::hasPendingChanges(void) const
+{
+    return !removedKeys.isEmpty() || !changedValues.isEmpty();
+}
+
+bool LiquidSettings::isModifiedElsewhere(void)
+{
+    const QDateTime fileModificationTime = getFileModificationTime();
+
+    if (fileModificationTime == parsedFileModificationTime) {
+        return false;
+    }
+
+    QMutexLocker locker(&writtenFileModificationTimesMutex);
+
+    // Written by this very process, what's in the file is already in memory
+    if (writtenFileModificationTimes.value(settingsFileName) == fileModificationTime) {
+        parsedFileModificationTime = fileModificationTime;
+        return false;
+    }
+
+    return true;
+}
+
+void LiquidSettings::parse(const QSettings& settings)
+{
+    values.clear();
+
+    foreach (const QString key, settings.allKeys()) {
+        values.insert(key, settings.value(key));
+    }
+
+    parsedFileModificationTime = getFileModificationTime();
+}
+
+LiquidSettings::Contents LiquidSettings::readFromDisk(const QString fileName, const QSettings::Format format)
+{
+    Contents contents;
+
+    // Taken first, so that whatever gets written while parsing makes it look modified again
+    const QFileInfo fileInfo(fileName);
+    contents.modificationTime = (fileInfo.exists()) ? fileInfo.lastModified() : QDateTime();
+
+    const QSettings settings(fileName, format);
+    foreach (const QString key, settings.allKeys()) {
+        contents.values.insert(key, settings.value(key));
+    }
+
+    return contents;
+}
+
+void LiquidSettings::reload(void)
+{
+    if (!isModifiedElsewhere()) {
+        return;
+    }
+
+    // Changes made within this process get written first, the same thread then parses the file with them in it
+    flush();
+
+    QFutureWatcher<Contents>* reloadWatcher = new QFutureWatcher<Contents>(this);
+    connect(reloadWatcher, &QFutureWatcher<Contents>::finished, this, [this, reloadWatcher]() {
+        const Contents contents = reloadWatcher->result();
+        reloadWatcher->deleteLater();
+
+        values = contents.values;
+        parsedFileModificationTime = contents.modificationTime;
+
+        // Changes made while the file was being parsed are newer than what it had in it
+        foreach (const QString key, removedKeys) {
+            removeKey(values, key);
+        }
+        for (QHash<QString, QVariant>::const_iterator it = changedValues.constBegin(); it != changedValues.constEnd(); ++it) {
+            values.insert(it.key(), it.value());
+        }
+
+        emit reloaded();
+    });
+    reloadWatcher->setFuture(QtConcurrent::run(getFlushThreadPool(), &LiquidSettings::readFromDisk, settingsFileName, settingsFormat));
+}
+
+void LiquidSettings::remove(const QString key)
+{
+    const QString fullKey = getFullKey(key);
+
+    removeKey(values, fullKey);
+    removeKey(changedValues, fullKey);
+    removedKeys.insert(fullKey);
+
+    flushTimer->start();
+}
+
+void LiquidSettings::removeKey(QHash<QString, QVariant>& keyValues, const QString fullKey)
+{
+    const QString groupPrefix = fullKey + "/";
+
+    // Same as QSettings: removing a group removes everything within it
+    foreach (const QString existingKey, keyValues.keys()) {
+        if (existingKey == fullKey || existingKey.startsWith(groupPrefix)) {
+            keyValues.remove(existingKey);
+        }
+    }
+}
+
+void LiquidSettings::setValue(const QString key, const QVariant value)
+{
+    const QString fullKey = getFullKey(key);
+
+    values.insert(fullKey, value);
+    changedValues.insert(fullKey, value);
+
+    flushTimer->start();
+}
+
+void LiquidSettings::sync(void)
+{
+    // Without an event loop, there's nothing to fire the timer
+    if (!QCoreApplication::instance()) {
+        flush();
+        waitForFlush();
+        return;
+    }
+
+    flush();
+}
+
+QVariant LiquidSettings::value(const QString key, const QVariant defaultValue) const
+{
+    return values.value(getFullKey(key), defaultValue);
+}
+
+void LiquidSettings::waitForFlush(void)
+{
+    // Hand over whatever is still waiting for its timer
+    foreach (LiquidSettings* settings, liquidAppSettings.values() << programSettings) {
+        if (settings) {
+            settings->flush();
+        }
+    }
+
+    if (flushThreadPool) {
+        flushThreadPool->waitForDone();
+    }
+}
+
+void LiquidSettings::writeToDisk(const QString fileName, const QSettings::Format format, const QString liquidAppName, const QSet<QString> removedKeys, const QHash<QString, QVariant> changedValues)
+{
+    QSettings settings(fileName, format);
+
+    // Removals go first, values set after removing the group they're in must stay
+    foreach (const QString key, removedKeys) {
+        settings.remove(key);
+    }
+
+    for (QHash<QString, QVariant>::const_iterator it = changedValues.constBegin(); it != changedValues.constEnd(); ++it) {
+        settings.setValue(it.key(), it.value());
+    }
+
+    settings.sync();
+
+    if (settings.status() != QSettings::NoError) {
+        qDebug().noquote() << QString("Unable to write settings to %1").arg(fileName);
+        return;
+    }
+
+    {
+        // Lets the GUI thread tell this write apart from those made by other processes
+        const QFileInfo fileInfo(fileName);
+        QMutexLocker locker(&writtenFileModificationTimesMutex);
+        writtenFileModificationTimes.insert(fileName, fileInfo.lastModified());
+    }
+
+    // Have everything ready for the next time this Liquid app gets started
+    if (!liquidAppName.isEmpty()) {
+        LiquidAppLaunchSnapshot::store(liquidAppName);
+    }
+}
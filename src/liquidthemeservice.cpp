@@ -0,0 +1,286 @@
+#include <QApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QPalette>
+#include <QSettings>
+
+#include "liquid.hpp"
+#include "liquidsettings.hpp"
+#include "liquidthemeservice.hpp"
+#include "lqd.h"
+
+#if defined(Q_OS_LINUX)
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#endif
+
+#if defined(Q_OS_MAC)
+#include <CoreFoundation/CoreFoundation.h>
+#include <CoreServices/CoreServices.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+static const QString portalService = "org.freedesktop.portal.Desktop";
+static const QString portalPath = "/org/freedesktop/portal/desktop";
+static const QString portalInterface = "org.freedesktop.portal.Settings";
+static const QString portalAppearanceNamespace = "org.freedesktop.appearance";
+static const QString gnomeInterfaceSchema = "org.gnome.desktop.interface";
+#endif
+
+/*
+ * Figures out whether the desktop uses a dark theme without ever blocking the GUI thread.
+ * The last known state is kept in the program's settings and used right away on startup,
+ * then gets corrected (and kept up to date) once the desktop reports its actual theme.
+ * On Linux that comes from the XDG desktop portal, which is one watcher for the whole session,
+ * with a one-off gsettings query being the fallback for desktops that have no portal.
+ * Setting LIQUID_THEME to "dark" or "light" overrides all of that.
+ *
+ * It also keeps an eye on the user-defined stylesheet,
+ * making the program's stylesheet get rebuilt whenever either of the two changes.
+ */
+LiquidThemeService* LiquidThemeService::instance(void)
+{
+    static LiquidThemeService* themeService = new LiquidThemeService(qApp);
+
+    return themeService;
+}
+
+LiquidThemeService::LiquidThemeService(QObject* parent) : QObject(parent)
+{
+    // Watch the directory too, the file may not exist yet or get replaced rather than modified
+    {
+        const QFileInfo userStyleSheetFileInfo(Liquid::getUserStyleSheetFilePath());
+        QDir().mkpath(userStyleSheetFileInfo.absolutePath());
+
+        userStyleSheetWatcher = new QFileSystemWatcher(QStringList() << userStyleSheetFileInfo.absolutePath(), this);
+        if (userStyleSheetFileInfo.exists()) {
+            userStyleSheetWatcher->addPath(userStyleSheetFileInfo.absoluteFilePath());
+            userStyleSheetModificationTime = userStyleSheetFileInfo.lastModified();
+            userStyleSheetSize = userStyleSheetFileInfo.size();
+        }
+
+        connect(userStyleSheetWatcher, &QFileSystemWatcher::directoryChanged, this, &LiquidThemeService::onUserStyleSheetChanged);
+        connect(userStyleSheetWatcher, &QFileSystemWatcher::fileChanged, this, &LiquidThemeService::onUserStyleSheetChanged);
+    }
+
+    const QString themeOverride = QString(qgetenv(LQD_ENV_VAR_THEME)).toLower();
+    if (!themeOverride.isEmpty()) {
+        darkMode = (themeOverride == "dark");
+        return;
+    }
+
+    // Start off with whatever was detected last time
+    darkMode = LiquidSettings::forProgram()->value(LQD_CFG_KEY_NAME_DARK_MODE, detectDarkModeFromPalette()).toBool();
+
+#if defined(Q_OS_LINUX)
+    // Get notified by the portal whenever the desktop's appearance changes
+    QDBusConnection::sessionBus().connect(portalService, portalPath, portalInterface, "SettingChanged",
+                                          this, SLOT(onPortalSettingChanged(QString, QString, QDBusVariant)));
+
+    queryPortal();
+#else
+    darkMode = detectSystemDarkMode();
+#endif
+
+    // The system can simply be asked again whenever the program gets focus
+    connect(qApp, &QGuiApplication::applicationStateChanged, this, [this](Qt::ApplicationState state) {
+        if (state == Qt::ApplicationActive) {
+            refresh();
+        }
+    });
+}
+
+LiquidThemeService::~LiquidThemeService(void)
+{
+    if (queryProcess != Q_NULLPTR && queryProcess->state() != QProcess::NotRunning) {
+        queryProcess->kill();
+        queryProcess->waitForFinished(100);
+    }
+}
+
+bool LiquidThemeService::detectDarkModeFromPalette(void)
+{
+    return QApplication::palette().text().color().lightnessF() > QApplication::palette().window().color().lightnessF();
+}
+
+bool LiquidThemeService::detectSystemDarkMode(void)
+{
+#if defined(Q_OS_MACOS)
+    static const QString macOsVer = QSysInfo::productVersion();
+    static const QStringList macOsVerParts = macOsVer.split('.');
+    if (macOsVerParts.at(0).toInt() > 10 || (macOsVerParts.at(0).toInt() >= 10 && macOsVerParts.at(1).toInt() >= 14)) {
+        bool macOsUserInterfaceIsUsingDarkMode = false;
+        CFStringRef darkStr = CFSTR("Dark");
+        CFStringRef macOsUserInterfaceStyleStr = CFSTR("AppleInterfaceStyle");
+        CFStringRef macOsUserInterfaceStyle = (CFStringRef)CFPreferencesCopyAppValue(macOsUserInterfaceStyleStr, kCFPreferencesCurrentApplication);
+        if (macOsUserInterfaceStyle != Q_NULLPTR) {
+            macOsUserInterfaceIsUsingDarkMode = (CFStringCompare(macOsUserInterfaceStyle, darkStr, 0) == kCFCompareEqualTo);
+            CFRelease(macOsUserInterfaceStyle);
+        }
+        return macOsUserInterfaceIsUsingDarkMode;
+    }
+#elif defined(Q_OS_WIN)
+    return (QSettings("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Themes\\Personalize", QSettings::NativeFormat)
+            .value("AppsUseLightTheme", 1) == 0);
+#endif
+
+    return detectDarkModeFromPalette();
+}
+
+bool LiquidThemeService::getLastKnownDarkMode(void)
+{
+    // Usable before QApplication gets constructed, e.g. for Chromium flags that need to be in place early on
+    const QString themeOverride = QString(qgetenv(LQD_ENV_VAR_THEME)).toLower();
+    if (!themeOverride.isEmpty()) {
+        return themeOverride == "dark";
+    }
+
+    return LiquidSettings::forProgram()->value(LQD_CFG_KEY_NAME_DARK_MODE, false).toBool();
+}
+
+bool LiquidThemeService::isDarkMode(void)
+{
+    return darkMode;
+}
+
+bool LiquidThemeService::isDarkThemeName(QString themeName)
+{
+    // gsettings puts quotes around string values, e.g. 'Adwaita-dark'
+    return themeName.remove('\'').endsWith("-dark", Qt::CaseInsensitive);
+}
+
+#if defined(Q_OS_LINUX)
+void LiquidThemeService::onPortalSettingChanged(const QString nameSpace, const QString key, const QDBusVariant value)
+{
+    if (nameSpace == portalAppearanceNamespace && key == "color-scheme") {
+        setColorScheme(value.variant().toUInt());
+    } else if (nameSpace == gnomeInterfaceSchema && key == "gtk-theme") {
+        // Only matters for desktops that don't have a preferred color scheme set
+        queryGsettings();
+    }
+}
+
+void LiquidThemeService::onQueryProcessFinished(void)
+{
+    const QString output = QString(queryProcess->readAllStandardOutput()).trimmed();
+    const bool isColorSchemeQuery = queryProcess->arguments().last() == "color-scheme";
+
+    if (isColorSchemeQuery) {
+        // Older desktops don't have this key, and 'default' means the user has no preference
+        if (output == "'prefer-dark'") {
+            setDarkMode(true);
+        } else if (output == "'prefer-light'") {
+            setDarkMode(false);
+        } else {
+            queryProcess->start("gsettings", QStringList() << "get" << gnomeInterfaceSchema << "gtk-theme");
+        }
+    } else if (output.size() > 0) {
+        setDarkMode(isDarkThemeName(output));
+    }
+}
+#endif
+
+void LiquidThemeService::onUserStyleSheetChanged(void)
+{
+    const QFileInfo userStyleSheetFileInfo(Liquid::getUserStyleSheetFilePath());
+    const qint64 size = (userStyleSheetFileInfo.exists()) ? userStyleSheetFileInfo.size() : -1;
+
+    // Plenty of other files live in the same directory
+    if (userStyleSheetFileInfo.lastModified() == userStyleSheetModificationTime && size == userStyleSheetSize) {
+        return;
+    }
+
+    userStyleSheetModificationTime = userStyleSheetFileInfo.lastModified();
+    userStyleSheetSize = size;
+
+    if (userStyleSheetFileInfo.exists() && !userStyleSheetWatcher->files().contains(userStyleSheetFileInfo.absoluteFilePath())) {
+        userStyleSheetWatcher->addPath(userStyleSheetFileInfo.absoluteFilePath());
+    }
+
+    Liquid::applyQtStyleSheets();
+}
+
+#if defined(Q_OS_LINUX)
+void LiquidThemeService::queryGsettings(void)
+{
+    if (queryProcess == Q_NULLPTR) {
+        queryProcess = new QProcess(this);
+        connect(queryProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &LiquidThemeService::onQueryProcessFinished);
+    }
+
+    if (queryProcess->state() != QProcess::NotRunning) {
+        return;
+    }
+
+    // The preferred color scheme goes first, the theme's name is what it falls back onto
+    queryProcess->start("gsettings", QStringList() << "get" << gnomeInterfaceSchema << "color-scheme");
+}
+
+void LiquidThemeService::queryPortal(void)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(portalService, portalPath, portalInterface, "Read");
+    message << portalAppearanceNamespace << "color-scheme";
+
+    QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher* watcher) {
+        QDBusPendingReply<QDBusVariant> reply = *watcher;
+
+        if (reply.isError()) {
+            // No portal to ask
+            queryGsettings();
+        } else {
+            // The value comes wrapped into one more variant
+            QVariant value = reply.value().variant();
+            if (value.canConvert<QDBusVariant>()) {
+                value = qvariant_cast<QDBusVariant>(value).variant();
+            }
+
+            setColorScheme(value.toUInt());
+        }
+
+        watcher->deleteLater();
+    });
+}
+#endif
+
+void LiquidThemeService::refresh(void)
+{
+#if defined(Q_OS_LINUX)
+    queryPortal();
+#else
+    setDarkMode(detectSystemDarkMode());
+#endif
+}
+
+#if defined(Q_OS_LINUX)
+void LiquidThemeService::setColorScheme(const uint colorScheme)
+{
+    // 1 stands for dark, 2 for light, and 0 for no preference at all
+    if (colorScheme == 1 || colorScheme == 2) {
+        setDarkMode(colorScheme == 1);
+    } else {
+        queryGsettings();
+    }
+}
+#endif
+
+void LiquidThemeService::setDarkMode(const bool isDarkMode)
+{
+    if (isDarkMode == darkMode) {
+        return;
+    }
+
+    darkMode = isDarkMode;
+
+    // Remember it for next time
+    LiquidSettings::forProgram()->setValue(LQD_CFG_KEY_NAME_DARK_MODE, darkMode);
+    LiquidSettings::forProgram()->sync();
+
+    // Re-style everything that's on screen
+    Liquid::applyQtStyleSheets();
+
+    emit darkModeChanged(darkMode);
+}
@@ -3,37 +3,42 @@
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDir>
-#include <QSettings>
+#include <QFile>
+#include <QWebEngineProfile>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QSocketNotifier>
+#endif
 
 #include "lqd.h"
 #include "liquid.hpp"
 #include "liquidappconfigwindow.hpp"
+#include "liquidapphost.hpp"
+#include "liquidinstanceserver.hpp"
 #include "liquidappwindow.hpp"
+#include "liquidinstanceregistry.hpp"
+#include "liquidlauncherdaemon.hpp"
+#include "liquidrenderingbackend.hpp"
+#include "liquidsettings.hpp"
 #include "mainwindow.hpp"
 
 QTextStream cout(stdout);
 
-static QSharedMemory* sharedMemory = Q_NULLPTR;
+static LiquidInstanceServer* instanceServer = Q_NULLPTR;
+static LiquidAppHost* liquidAppHost = Q_NULLPTR;
 
 LiquidAppWindow* liquidAppWindow;
 MainWindow* mainWindow;
 
-QString getUserName()
-{
-    QString name = qgetenv("USER");
-
-    if (name.isEmpty()) {
-        name = qgetenv("USERNAME");
-    }
-
-    return name;
-}
-
-static void onSignalHandler(int signum)
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+static void cleanUp(void)
 {
-    if (sharedMemory) {
-        delete sharedMemory;
-        sharedMemory = Q_NULLPTR;
+    if (liquidAppHost) {
+        delete liquidAppHost;
+        liquidAppHost = Q_NULLPTR;
     }
 
     if (liquidAppWindow) {
@@ -48,28 +53,89 @@ static void onSignalHandler(int signum)
         mainWindow = Q_NULLPTR;
     }
 
+    if (instanceServer) {
+        delete instanceServer;
+        instanceServer = Q_NULLPTR;
+    }
+}
+
+// Termination signals get passed through this pipe, to be dealt with within the event loop
+static int signalPipeFds[2] = { -1, -1 };
+
+static void onFatalSignalHandler(int signum)
+{
+    // The event loop can't be relied on to ever run again, nor can settings be waited for from within here
+    cleanUp();
+
     qDebug() << "Terminated with signal" << signum;
 
     exit(128 + signum);
 }
 
+static void onSignalHandler(int signum)
+{
+    // Only async-signal-safe calls are allowed in here
+    const unsigned char signalNumber = signum;
+    if (write(signalPipeFds[1], &signalNumber, sizeof(signalNumber)) < 0) {
+        _exit(128 + signum);
+    }
+}
+
+static void onSignalReceived(void)
+{
+    unsigned char signalNumber;
+    if (read(signalPipeFds[0], &signalNumber, sizeof(signalNumber)) != sizeof(signalNumber)) {
+        return;
+    }
+
+    cleanUp();
+
+    // Settings saved by windows above are still being written
+    LiquidSettings::waitForFlush();
+
+    qDebug() << "Terminated with signal" << signalNumber;
+
+    exit(128 + signalNumber);
+}
+#endif
+
 int main(int argc, char **argv)
 {
     int ret = EXIT_SUCCESS;
 
+    // Asked by another Liquid process what OpenGL renders with here (see LiquidRenderingBackend::detect()),
+    // has to happen before any rendering attributes get set
+    if (argc == 2 && qstrcmp(argv[1], LQD_RENDERING_PROBE_FLAG) == 0) {
+        QApplication app(argc, argv);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        cout << LiquidRenderingBackend::getGlRenderer() << Qt::endl;
+#else
+        cout << LiquidRenderingBackend::getGlRenderer() << endl;
+#endif
+
+        return ret;
+    }
+
 #if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
     // Handle any further termination signals to ensure
-    // that the QSharedMemory block is deleted
+    // that windows get to save their settings
     // even if the process crashes
+    if (pipe(signalPipeFds) == 0) {
+        for (int i = 0; i < 2; i++) {
+            fcntl(signalPipeFds[i], F_SETFD, FD_CLOEXEC);
+            fcntl(signalPipeFds[i], F_SETFL, fcntl(signalPipeFds[i], F_GETFL) | O_NONBLOCK);
+        }
+    }
     signal(SIGHUP,  onSignalHandler);
     signal(SIGINT,  onSignalHandler);
     signal(SIGQUIT, onSignalHandler);
-    signal(SIGILL,  onSignalHandler);
-    signal(SIGABRT, onSignalHandler);
-    signal(SIGFPE,  onSignalHandler);
-    signal(SIGBUS,  onSignalHandler);
-    signal(SIGSEGV, onSignalHandler);
-    signal(SIGSYS,  onSignalHandler);
+    signal(SIGILL,  onFatalSignalHandler);
+    signal(SIGABRT, onFatalSignalHandler);
+    signal(SIGFPE,  onFatalSignalHandler);
+    signal(SIGBUS,  onFatalSignalHandler);
+    signal(SIGSEGV, onFatalSignalHandler);
+    signal(SIGSYS,  onFatalSignalHandler);
     signal(SIGPIPE, onSignalHandler);
     signal(SIGALRM, onSignalHandler);
     signal(SIGTERM, onSignalHandler);
@@ -82,21 +148,70 @@ int main(int argc, char **argv)
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 #endif
 
-    QCoreApplication::setAttribute(Qt::AA_UseOpenGLES, true);
+    // Only makes sense to have Qt go for hardware-accelerated OpenGL when there's a usable GPU
+    QCoreApplication::setAttribute((LiquidRenderingBackend::isGpuUsable()) ? Qt::AA_UseOpenGLES : Qt::AA_UseSoftwareOpenGL, true);
+
+    // Tune web engine, this has to happen before QApplication gets constructed,
+    // which is way before command line arguments get parsed properly
+    {
+        QString liquidAppName;
+
+        for (int i = 1; i < argc; i++) {
+            const QByteArray arg(argv[i]);
+
+            // Processes that run several Liquid apps (or don't know which one yet) can only go with flags common to all
+            if (arg == "--host" || arg == "--standby") {
+                liquidAppName.clear();
+                break;
+            }
+
+            if (!arg.startsWith('-') && liquidAppName.isEmpty()) {
+                liquidAppName = QString::fromLocal8Bit(arg).replace(QDir::separator(), "_");
+            }
+        }
+
+        Liquid::applyChromiumFlags(liquidAppName);
+    }
 
     QApplication app(argc, argv);
 
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+    // Signals caught so far are waiting in the pipe, they get dealt with as soon as the event loop starts
+    if (signalPipeFds[0] != -1) {
+        QSocketNotifier* signalNotifier = new QSocketNotifier(signalPipeFds[0], QSocketNotifier::Read, &app);
+        QObject::connect(signalNotifier, &QSocketNotifier::activated, &app, onSignalReceived);
+    }
+#endif
+
     if (argc < 2) {
-        // Allow only one instance
-        sharedMemory = new QSharedMemory(getUserName() + "_Liquid");
-        if (!sharedMemory->create(4, QSharedMemory::ReadOnly)) {
-            delete sharedMemory;
+        // Allow only one instance, bring up the one that's already running instead
+        if (LiquidInstanceServer::requestActivation(QString())) {
+            return ret;
+        }
+        instanceServer = new LiquidInstanceServer(QString());
+        if (!instanceServer->listen()) {
+            delete instanceServer;
+            instanceServer = Q_NULLPTR;
             qDebug().noquote() << QString("Only one instance of Liquid is allowed");
             exit(EXIT_FAILURE);
         }
 
+        // Find out what this machine is capable of, in case it's not known yet;
+        // only processes that go on to show windows do that, short-lived ones would kill the probe on their way out
+        LiquidRenderingBackend::detectUnlessKnown();
+
+        // Style the whole program at once
+        Liquid::applyQtStyleSheets();
+
         // Show main program window
         mainWindow = new MainWindow;
+
+        QObject::connect(instanceServer, &LiquidInstanceServer::activationRequested, mainWindow, []() {
+            mainWindow->setWindowState(mainWindow->windowState() & ~Qt::WindowMinimized);
+            mainWindow->show();
+            mainWindow->raise();
+            mainWindow->activateWindow();
+        });
     } else  { // App name provided
         // CLI flags and options
         QCommandLineParser parser;
@@ -108,6 +223,7 @@ int main(int argc, char **argv)
         parser.addHelpOption();
         parser.addVersionOption();
         parser.addPositionalArgument("app-name", QCoreApplication::translate("main", "Liquid App name"));
+        parser.addPositionalArgument("url", QCoreApplication::translate("main", "URL to open within the Liquid App"), "[url]");
 
         // Set up CLI flags and options
         const QCommandLineOption listAppsFlag(QStringList() << "l" << "list-apps",
@@ -116,12 +232,42 @@ int main(int argc, char **argv)
         const QCommandLineOption editAppDialogFlag(QStringList() << "E" << "edit-app-dialog",
                 QCoreApplication::translate("main", "Open edit Liquid App dialog"));
         parser.addOption(editAppDialogFlag);
+        const QCommandLineOption launcherDaemonFlag(QStringList() << "launcher-daemon",
+                QCoreApplication::translate("main", "Keep a pre-initialized process ready for running Liquid Apps faster"));
+        parser.addOption(launcherDaemonFlag);
+        const QCommandLineOption standbyFlag(QStringList() << "standby",
+                QCoreApplication::translate("main", "Wait for the launcher daemon to tell which Liquid App to run (used internally)"));
+        parser.addOption(standbyFlag);
+        const QCommandLineOption hostFlag(QStringList() << "host",
+                QCoreApplication::translate("main", "Run Liquid Apps within a single resident process"));
+        parser.addOption(hostFlag);
+        const QCommandLineOption hostStatsFlag(QStringList() << "host-stats",
+                QCoreApplication::translate("main", "Show memory used by the Liquid App host and by Liquid Apps running on their own"));
+        parser.addOption(hostStatsFlag);
+        const QCommandLineOption statusFlag(QStringList() << "status",
+                QCoreApplication::translate("main", "Show running Liquid Apps along with their memory and CPU usage"));
+        parser.addOption(statusFlag);
+        const QCommandLineOption verboseFlag(QStringList() << "verbose",
+                QCoreApplication::translate("main", "Print effective web engine flags"));
+        parser.addOption(verboseFlag);
+        const QCommandLineOption diagnosticsFlag(QStringList() << "diagnostics",
+                QCoreApplication::translate("main", "Detect and show what rendering backend gets used on this machine"));
+        parser.addOption(diagnosticsFlag);
+        const QCommandLineOption memoryReportFlag(QStringList() << "memory-report",
+                QCoreApplication::translate("main", "Measure how much memory the Liquid App takes with and without low-memory mode"));
+        parser.addOption(memoryReportFlag);
 
         // Process the actual command line arguments given by the user
         parser.process(app);
 
+        // Process the --verbose flag
+        if (parser.isSet(verboseFlag)) {
+            qDebug().noquote() << QString("Chromium flags: %1").arg(QString(qgetenv("QTWEBENGINE_CHROMIUM_FLAGS")));
+        }
+
         const QStringList args = parser.positionalArguments();
         QString liquidAppName = (args.size() > 0) ? args.at(0) : "";
+        const QUrl urlToOpen = (args.size() > 1) ? QUrl::fromUserInput(args.at(1)) : QUrl();
 
         // Replace directory separators (slashes) with underscores
         // to ensure no sub-directories would get created
@@ -139,26 +285,234 @@ int main(int argc, char **argv)
             return ret;
         }
 
+        // Process the --diagnostics flag
+        if (parser.isSet(diagnosticsFlag)) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+            cout << LiquidRenderingBackend::getDiagnostics().join("\n") << Qt::endl;
+#else
+            cout << LiquidRenderingBackend::getDiagnostics().join("\n") << endl;
+#endif
+            return ret;
+        }
+
+        // Process the --host-stats flag
+        if (parser.isSet(hostStatsFlag)) {
+            QStringList lines;
+
+            qint64 hostProcessId = 0;
+            int hostedLiquidAppCount = 0;
+            if (LiquidAppHost::requestStats(&hostProcessId, &hostedLiquidAppCount)) {
+                const qint64 memoryUsage = Liquid::getProcessTreeMemoryUsage(hostProcessId);
+                QString line = QString("Host (PID %1): %2 Liquid App(s), %3")
+                                    .arg(hostProcessId)
+                                    .arg(hostedLiquidAppCount)
+                                    .arg(Liquid::getReadableMemoryUsage(memoryUsage));
+                if (hostedLiquidAppCount > 0 && memoryUsage > 0) {
+                    line += QString(" (%1 per Liquid App)").arg(Liquid::getReadableMemoryUsage(memoryUsage / hostedLiquidAppCount));
+                }
+                lines << line;
+            } else {
+                lines << QString("Host is not running");
+            }
+
+            // Everything else: Liquid apps running on their own, the launcher daemon, etc
+            foreach (const qint64 processId, Liquid::getLiquidProcessIds()) {
+                if (processId == hostProcessId || processId == QCoreApplication::applicationPid()) {
+                    continue;
+                }
+
+                QFile cmdlineFile(QString("/proc/%1/cmdline").arg(processId));
+                cmdlineFile.open(QIODevice::ReadOnly);
+                const QString cmdline = QString::fromUtf8(cmdlineFile.readAll()).replace(QChar('\0'), QChar(' ')).trimmed();
+
+                lines << QString("%1 (PID %2): %3")
+                            .arg(cmdline)
+                            .arg(processId)
+                            .arg(Liquid::getReadableMemoryUsage(Liquid::getProcessTreeMemoryUsage(processId)));
+            }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+            cout << lines.join("\n") << Qt::endl;
+#else
+            cout << lines.join("\n") << endl;
+#endif
+            return ret;
+        }
+
+        // Process the --status flag
+        if (parser.isSet(statusFlag)) {
+            const auto formatCpuUsage = [](const qreal cpuUsage) {
+                return (cpuUsage < 0) ? QString("unknown") : QString("%1%").arg(cpuUsage, 0, 'f', 1);
+            };
+
+            QList<QStringList> rows;
+            rows << (QStringList() << "APP" << "PID" << "STARTED" << "MEMORY" << "CPU" << "RENDERER PID" << "RENDERER MEMORY" << "RENDERER CPU");
+            foreach (const LiquidInstanceRegistry::Record record, LiquidInstanceRegistry::getRecords()) {
+                rows << (QStringList() << record.liquidAppName
+                                       << QString::number(record.processId)
+                                       << record.startTime.toLocalTime().toString(Qt::ISODate)
+                                       << Liquid::getReadableMemoryUsage(record.memoryUsage)
+                                       << formatCpuUsage(record.cpuUsage)
+                                       << ((record.renderProcessId > 0) ? QString::number(record.renderProcessId) : QString("unknown"))
+                                       << Liquid::getReadableMemoryUsage(record.renderProcessMemoryUsage)
+                                       << formatCpuUsage(record.renderProcessCpuUsage));
+            }
+
+            // Line columns up
+            QList<int> columnWidths;
+            foreach (const QStringList row, rows) {
+                for (int i = 0; i < row.size(); i++) {
+                    if (i >= columnWidths.size()) {
+                        columnWidths << 0;
+                    }
+                    columnWidths[i] = qMax(columnWidths.at(i), row.at(i).size());
+                }
+            }
+
+            QStringList lines;
+            foreach (const QStringList row, rows) {
+                QStringList cells;
+                for (int i = 0; i < row.size(); i++) {
+                    cells << row.at(i).leftJustified(columnWidths.at(i));
+                }
+                lines << cells.join("  ").trimmed();
+            }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+            cout << lines.join("\n") << Qt::endl;
+#else
+            cout << lines.join("\n") << endl;
+#endif
+            return ret;
+        }
+
+        // Process the --memory-report flag
+        if (parser.isSet(memoryReportFlag)) {
+            foreach (const LiquidInstanceRegistry::Record record, LiquidInstanceRegistry::getRecords()) {
+                if (record.liquidAppName == liquidAppName) {
+                    qDebug().noquote() << QString("Liquid App “%1” needs to be closed first").arg(liquidAppName);
+                    return EXIT_FAILURE;
+                }
+            }
+
+            const qint64 defaultMemoryUsage = Liquid::measureLiquidAppMemoryUsage(liquidAppName, false);
+            const qint64 lowMemoryUsage = Liquid::measureLiquidAppMemoryUsage(liquidAppName, true);
+
+            QStringList lines;
+            lines << QString("Liquid App: %1").arg(liquidAppName);
+            lines << QString("Default:         %1").arg(Liquid::getReadableMemoryUsage(defaultMemoryUsage));
+            lines << QString("Low-memory mode: %1").arg(Liquid::getReadableMemoryUsage(lowMemoryUsage));
+            if (defaultMemoryUsage > 0 && lowMemoryUsage > 0) {
+                lines << QString("Difference:      %1%2 (%3%)")
+                            .arg((lowMemoryUsage > defaultMemoryUsage) ? "+" : "-")
+                            .arg(Liquid::getReadableMemoryUsage(qAbs(lowMemoryUsage - defaultMemoryUsage)))
+                            .arg((lowMemoryUsage - defaultMemoryUsage) * 100.0 / defaultMemoryUsage, 0, 'f', 1);
+            }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+            cout << lines.join("\n") << Qt::endl;
+#else
+            cout << lines.join("\n") << endl;
+#endif
+            return (defaultMemoryUsage > 0 && lowMemoryUsage > 0) ? ret : EXIT_FAILURE;
+        }
+
+        // Process the --launcher-daemon flag
+        if (parser.isSet(launcherDaemonFlag)) {
+            LiquidLauncherDaemon launcherDaemon;
+            if (!launcherDaemon.listen()) {
+                return EXIT_FAILURE;
+            }
+            return app.exec();
+        }
+
+        // Process the --host flag
+        if (parser.isSet(hostFlag)) {
+            Liquid::applyQtStyleSheets();
+
+            liquidAppHost = new LiquidAppHost;
+            if (!liquidAppHost->listen()) {
+                return EXIT_FAILURE;
+            }
+
+            // Find out what this machine is capable of, in case it's not known yet
+            LiquidRenderingBackend::detectUnlessKnown();
+
+            // Stay around for Liquid apps to be run later
+            app.setQuitOnLastWindowClosed(false);
+
+            // Run whatever Liquid apps were provided along with the flag
+            foreach (QString arg, args) {
+                liquidAppHost->launch(arg.replace(QDir::separator(), "_"));
+            }
+
+            ret = app.exec();
+
+            delete liquidAppHost;
+            liquidAppHost = Q_NULLPTR;
+
+            return ret;
+        }
+
+        // Style the whole program at once
+        Liquid::applyQtStyleSheets();
+
+        // Process the --standby flag
+        if (parser.isSet(standbyFlag)) {
+            // Get the web engine up and running ahead of time.
+            // This profile is never used for any pages, Liquid apps still get their own.
+            new QWebEngineProfile(QString(), &app);
+
+            LiquidRenderingBackend::detectUnlessKnown();
+
+            liquidAppName = LiquidLauncherDaemon::waitForLaunchRequest();
+            if (liquidAppName.isEmpty()) {
+                return ret;
+            }
+            liquidAppName = liquidAppName.replace(QDir::separator(), "_");
+        }
+
 attempt_to_create_or_run_liquid_app:
-        // Attempt to load Liquid app's config file
-        QSettings* tempAppSettings = new QSettings(QSettings::IniFormat,
-                                                   QSettings::UserScope,
-                                                   QString(PROG_NAME) + QDir::separator() + LQD_APPS_DIR_NAME,
-                                                   liquidAppName,
-                                                   Q_NULLPTR);
+        // Attempt to load Liquid app's config file (parsed once, Liquid app's window gets the same copy)
+        const LiquidSettings* tempAppSettings = LiquidSettings::forLiquidApp(liquidAppName);
 
         // Attempt to load app settings from a config file
         if (!parser.isSet(editAppDialogFlag) && tempAppSettings->contains(LQD_CFG_KEY_NAME_URL)) {
-            // // Allow only one instance
-            sharedMemory = new QSharedMemory(getUserName() + "_Liquid_app_" + liquidAppName);
-            if (!sharedMemory->create(4, QSharedMemory::ReadOnly)) {
-                delete sharedMemory;
+            // Allow only one instance, bring up the one that's already running instead
+            if (LiquidInstanceServer::requestActivation(liquidAppName, urlToOpen)) {
+                goto done;
+            }
+
+            // Let the app host run it if there's one running;
+            // being measured (see --memory-report) requires a process of its own
+            if (!parser.isSet(standbyFlag) && !qEnvironmentVariableIsSet(LQD_ENV_VAR_LOW_MEMORY)
+                && LiquidAppHost::requestLaunch(liquidAppName, urlToOpen)
+            ) {
+                goto done;
+            }
+
+            instanceServer = new LiquidInstanceServer(liquidAppName);
+            if (!instanceServer->listen()) {
+                delete instanceServer;
+                instanceServer = Q_NULLPTR;
                 qDebug().noquote() << QString("Only one instance of Liquid app “%1” is allowed").arg(liquidAppName);
                 exit(EXIT_FAILURE);
             }
 
+            LiquidRenderingBackend::detectUnlessKnown();
+
             // Found existing liquid app settings file, show it
             liquidAppWindow = new LiquidAppWindow(&liquidAppName);
+
+            // Nothing left to do once it's gone (including when it fails to get set up)
+            QObject::connect(liquidAppWindow, &QObject::destroyed, &app, []() {
+                liquidAppWindow = Q_NULLPTR;
+                QCoreApplication::quit();
+            });
+            QObject::connect(instanceServer, &LiquidInstanceServer::activationRequested, liquidAppWindow, &LiquidAppWindow::activate);
+            if (urlToOpen.isValid()) {
+                liquidAppWindow->activate(urlToOpen);
+            }
         } else {
             // No such Liquid app found, open Liquid app creation dialog
             LiquidAppConfigDialog LiquidAppConfigDialog(mainWindow, liquidAppName);
@@ -194,9 +548,9 @@ attempt_to_create_or_run_liquid_app:
     ret = app.exec();
 
 done:
-    if (sharedMemory != Q_NULLPTR) {
-        delete sharedMemory;
-        sharedMemory = Q_NULLPTR;
+    if (instanceServer != Q_NULLPTR) {
+        delete instanceServer;
+        instanceServer = Q_NULLPTR;
     }
 
     return ret;
@@ -7,6 +7,11 @@
 
 #include "liquid.hpp"
 #include "liquidappconfigwindow.hpp"
+#include "liquidappcookiestore.hpp"
+#include "liquidappiconcache.hpp"
+#include "liquidapplaunchsnapshot.hpp"
+#include "liquidappwindow.hpp"
+#include "liquidinstanceregistry.hpp"
 #include "lqd.h"
 #include "mainwindow.hpp"
 
@@ -22,7 +27,7 @@ MainWindow::MainWindow() : QScrollArea()
     setWindowIcon(QIcon(":/images/" PROG_NAME ".svg"));
 #endif
 
-    settings = new QSettings(PROG_NAME, PROG_NAME);
+    settings = LiquidSettings::forProgram();
     if (settings->contains(LQD_CFG_KEY_NAME_WIN_GEOM)) {
         QByteArray geometry = QByteArray::fromHex(
             settings->value(LQD_CFG_KEY_NAME_WIN_GEOM).toByteArray()
@@ -30,7 +35,7 @@ MainWindow::MainWindow() : QScrollArea()
         restoreGeometry(geometry);
     }
 
-    Liquid::applyQtStyleSheets(this);
+    liquidAppIndex = new LiquidAppIndex(this);
 
     QWidget* mainWindowWidget = new QWidget();
     setWidget(mainWindowWidget);
@@ -39,16 +44,28 @@ MainWindow::MainWindow() : QScrollArea()
     mainWindowLayout->setSpacing(0);
     mainWindowLayout->setContentsMargins(0, 0, 0, 0);
 
-    appListTable = new QTableWidget();
-    appListTable->setColumnCount(2);
-    appListTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
-    appListTable->horizontalHeader()->hide();
-    appListTable->verticalHeader()->hide();
-    appListTable->setShowGrid(false);
-    appListTable->setFocusPolicy(Qt::NoFocus);
-    // appListTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    appListTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    mainWindowLayout->addWidget(appListTable);
+    // Rows are painted on demand by the delegate, no widgets get created per Liquid app
+    appListModel = new LiquidAppsListModel(this);
+    appListDelegate = new LiquidAppsListDelegate(this);
+    appListView = new LiquidAppsListView();
+    appListView->setModel(appListModel);
+    appListView->setItemDelegate(appListDelegate);
+    appListView->horizontalHeader()->setSectionResizeMode(LiquidAppsListModel::NameColumn, QHeaderView::Stretch);
+    appListView->horizontalHeader()->setSectionResizeMode(LiquidAppsListModel::StatusColumn, QHeaderView::ResizeToContents);
+    appListView->horizontalHeader()->setSectionResizeMode(LiquidAppsListModel::ActionsColumn, QHeaderView::Fixed);
+    appListView->horizontalHeader()->resizeSection(LiquidAppsListModel::ActionsColumn, LiquidAppsListDelegate::ActionCount * LQD_APP_LIST_BTN_W);
+    appListView->horizontalHeader()->hide();
+    appListView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    appListView->verticalHeader()->hide();
+    appListView->setShowGrid(false);
+    appListView->setFocusPolicy(Qt::NoFocus);
+    // appListView->setSelectionMode(QAbstractItemView::SingleSelection);
+    appListView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    appListView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    // Needed for action buttons to react to the mouse cursor hovering over them
+    appListView->setMouseTracking(true);
+    appListView->viewport()->setAttribute(Qt::WA_Hover);
+    mainWindowLayout->addWidget(appListView);
 
     // Add new liquid app button
     createNewLiquidAppButton = new QPushButton(tr(LQD_ICON_ADD));
@@ -57,14 +74,7 @@ MainWindow::MainWindow() : QScrollArea()
         LiquidAppConfigDialog LiquidAppConfigDialog(this, "");
         switch (LiquidAppConfigDialog.exec()) {
             case QDialog::Accepted:
-                // Give some time to the filesystem before scanning for the newly created Liquid App
-                {
-                    QTime proceedAfter = QTime::currentTime().addMSecs(100);
-                    while (QTime::currentTime() < proceedAfter) {
-                        QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
-                    }
-                }
-                flushTable();
+                // The config file is already synced by now
                 populateTable();
 
                 if (LiquidAppConfigDialog.isPlanningToRun()) {
@@ -78,11 +88,63 @@ MainWindow::MainWindow() : QScrollArea()
     mainWindowWidget->setLayout(mainWindowLayout);
 
     // Run the liquid app upon double-click on its row in the table
-    connect(appListTable, &QTableWidget::cellDoubleClicked, [&](int row, int col) {
-        Q_UNUSED(col);
-        Liquid::runLiquidApp(appListTable->item(row, 0)->text());
+    connect(appListView, &QTableView::doubleClicked, [&](const QModelIndex& index) {
+        Liquid::runLiquidApp(appListModel->getLiquidAppName(index));
     });
 
+    // Handle clicks on action buttons
+    connect(appListDelegate, &LiquidAppsListDelegate::actionTriggered, [&](const LiquidAppsListDelegate::Action action, const QModelIndex& index) {
+        const QString liquidAppName = appListModel->getLiquidAppName(index);
+
+        switch (action) {
+            case LiquidAppsListDelegate::DeleteAction:
+                deleteLiquidApp(liquidAppName);
+            break;
+
+            case LiquidAppsListDelegate::EditAction:
+                editLiquidApp(liquidAppName);
+            break;
+
+            case LiquidAppsListDelegate::RunAction:
+                Liquid::runLiquidApp(liquidAppName);
+            break;
+
+            default:
+            break;
+        }
+    });
+
+    // Pick up Liquid apps created, modified or removed elsewhere (e.g. via CLI or another instance)
+    {
+        QDir().mkpath(Liquid::getAppsDir().absolutePath());
+
+        // Coalesce bursts of changes (config files get written in several steps) into a single refresh
+        appsDirRefreshTimer = new QTimer(this);
+        appsDirRefreshTimer->setSingleShot(true);
+        appsDirRefreshTimer->setInterval(LQD_APP_LIST_DEBOUNCE);
+        connect(appsDirRefreshTimer, &QTimer::timeout, this, &MainWindow::populateTable);
+
+        appsDirWatcher = new QFileSystemWatcher(QStringList() << Liquid::getAppsDir().absolutePath(), this);
+        connect(appsDirWatcher, &QFileSystemWatcher::directoryChanged, [&]() {
+            appsDirRefreshTimer->start();
+        });
+    }
+
+    // Keep memory and CPU usage of running Liquid apps up to date
+    {
+        instanceRecordsRefreshTimer = new QTimer(this);
+        instanceRecordsRefreshTimer->setInterval(LQD_INSTANCE_STATS_INTERVAL);
+        connect(instanceRecordsRefreshTimer, &QTimer::timeout, [&]() {
+            // Nobody to show them to
+            if (!isVisible() || isMinimized()) {
+                return;
+            }
+
+            appListModel->setInstanceRecords(LiquidInstanceRegistry::getRecords());
+        });
+        instanceRecordsRefreshTimer->start();
+    }
+
     // Connect keyboard shortcuts
     bindShortcuts();
 
@@ -115,131 +177,84 @@ void MainWindow::closeEvent(QCloseEvent *event)
     event->accept();
 }
 
-void MainWindow::flushTable(void)
+void MainWindow::deleteLiquidApp(const QString liquidAppName)
 {
-    for (int i = appListTable->rowCount(); i > -1 ; i--) {
-        appListTable->removeRow(i);
-    }
-}
+    const QString text = QString("Are you sure you want to delete Liquid app “%1”?").arg(liquidAppName);
+    const QMessageBox::StandardButton reply = QMessageBox::question(this, "Confirmation", text, QMessageBox::Yes | QMessageBox::No);
+    if (reply == QMessageBox::Yes) {
+        Liquid::removeDesktopFile(liquidAppName);
+
+        QString liquidAppIcon;
+        foreach (const LiquidAppIndex::Entry liquidAppIndexEntry, liquidAppIndex->getEntries()) {
+            if (liquidAppIndexEntry.name == liquidAppName) {
+                liquidAppIcon = liquidAppIndexEntry.icon;
+                break;
+            }
+        }
 
-void MainWindow::populateTable(void)
-{
-    foreach (const QString liquidAppName, Liquid::getLiquidAppsList()) {
-        const int i = appListTable->rowCount();
-
-        appListTable->insertRow(i);
-
-        QSettings* liquidAppConfig = new QSettings(QSettings::IniFormat,
-                                                   QSettings::UserScope,
-                                                   QString(PROG_NAME "%1" LQD_APPS_DIR_NAME).arg(QDir::separator()),
-                                                   liquidAppName,
-                                                   Q_NULLPTR);
-
-        //////////////////
-        // First column //
-        //////////////////
-
-        QTableWidgetItem* appItemWidgetFirstColumn = new QTableWidgetItem();
-        // Make them read-only (no text edit upon double-click)
-        appItemWidgetFirstColumn->setFlags(appItemWidgetFirstColumn->flags() ^ Qt::ItemIsEditable);
-        if (liquidAppConfig->contains(LQD_CFG_KEY_NAME_ICON)) {
-            QPixmap pixmap;
-            pixmap.loadFromData(QByteArray::fromBase64(liquidAppConfig->value(LQD_CFG_KEY_NAME_ICON).toByteArray().remove(0, 22)), "PNG");
-            appItemWidgetFirstColumn->setIcon(QIcon(pixmap));
+        // Shred and unlink Liquid app settings file
+        LiquidSettings::forgetLiquidApp(liquidAppName);
+        const QString liquidAppConfigFilePath = Liquid::getAppsDir().absoluteFilePath(liquidAppName + ".ini");
+        if (Liquid::shredFile(liquidAppConfigFilePath)) {
+            qDebug().noquote() << QString("Removed config file for Liquid app %1").arg(liquidAppName);
         } else {
-            appItemWidgetFirstColumn->setIcon(QIcon(":/images/" PROG_NAME ".svg"));
+            qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(liquidAppConfigFilePath);
         }
-        appItemWidgetFirstColumn->setText(liquidAppName);
-        appListTable->setItem(i, 0, appItemWidgetFirstColumn);
-
-        ///////////////////
-        // Second column //
-        ///////////////////
-
-        QWidget* appItemActionButtonsWidget = new QWidget(this);
-        QHBoxLayout *appItemLayout = new QHBoxLayout();
-        appItemLayout->setSpacing(0);
-        appItemLayout->setContentsMargins(0, 0, 0, 0);
-        appItemActionButtonsWidget->setLayout(appItemLayout);
-
-        // Delete button
-        QPushButton* deleteButton = new QPushButton(tr(LQD_ICON_DELETE), this);
-        deleteButton->setCursor(Qt::PointingHandCursor);
-        deleteButton->setProperty("class", "liquidAppsListButtonDelete");
-        connect(deleteButton, &QPushButton::clicked, [this, liquidAppName, liquidAppConfig]() {
-            const QString text = QString("Are you sure you want to delete Liquid app “%1”?").arg(liquidAppName);
-            const QMessageBox::StandardButton reply = QMessageBox::question(this, "Confirmation", text, QMessageBox::Yes | QMessageBox::No);
-            if (reply == QMessageBox::Yes) {
-                Liquid::removeDesktopFile(liquidAppName);
-
-                // Shred and unlink Liquid app settings file
-                QFile liquidAppConfigFile(liquidAppConfig->fileName());
-                // Open file handle
-                if (liquidAppConfigFile.open(QIODevice::ReadWrite)) {
-                    // Determine file length
-                    const int liquidAppConfigFileSize = liquidAppConfigFile.size();
-                    // Shred (especially important if it contains Cookie data)
-                    for (int i = 0, imax = 5; i < imax; i++) {
-                        // Write randomly generated array of bytes to disk
-                        liquidAppConfigFile.write(Liquid::generateRandomByteArray(liquidAppConfigFileSize), liquidAppConfigFileSize);
-                        // Close file handle
-                        liquidAppConfigFile.close();
-
-                        if (i < imax - 1) {
-                            // Put cursor back to start (to write again across the same byte range instead of appending data upon next iteration)
-                            liquidAppConfigFile.open(QIODevice::ReadWrite);
-                        } else {
-                            // Unlink file
-                            liquidAppConfigFile.remove();
-                            qDebug().noquote() << QString("Removed config file for Liquid app %1").arg(liquidAppName);
-                        }
-                    }
-                } else {
-                    qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(liquidAppConfig->fileName());
-                }
 
-                // Refresh table
-                flushTable();
-                populateTable();
+        // Shred and unlink Liquid app cookie store files
+        foreach (const QString cookieStoreFilePath, QStringList() << LiquidAppCookieStore::getSnapshotFilePath(liquidAppName)
+                                                                  << LiquidAppCookieStore::getJournalFilePath(liquidAppName)) {
+            if (QFile::exists(cookieStoreFilePath) && !Liquid::shredFile(cookieStoreFilePath)) {
+                qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(cookieStoreFilePath);
             }
-        });
-        appItemLayout->addWidget(deleteButton);
-
-        // Edit button
-        QPushButton* editButton = new QPushButton(tr(LQD_ICON_EDIT), this);
-        editButton->setCursor(Qt::PointingHandCursor);
-        editButton->setProperty("class", "liquidAppsListButtonEdit");
-        connect(editButton, &QPushButton::clicked, [this, liquidAppName]() {
-            LiquidAppConfigDialog LiquidAppConfigDialog(this, liquidAppName);
-            switch (LiquidAppConfigDialog.exec()) {
-                case QDialog::Accepted:
-                    // Give some time to the filesystem before scanning for the newly created app
-                    {
-                        QTime proceedAfter = QTime::currentTime().addMSecs(100);
-                        while (QTime::currentTime() < proceedAfter) {
-                            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
-                        }
-                    }
-                    flushTable();
-                    populateTable();
-                break;
+        }
+
+        // Shred and unlink Liquid app launch snapshot (has everything the settings file had) and splash image
+        foreach (const QString snapshotFilePath, QStringList() << LiquidAppLaunchSnapshot::getFilePath(liquidAppName)
+                                                               << LiquidAppWindow::getSplashFilePath(liquidAppName)) {
+            if (QFile::exists(snapshotFilePath) && !Liquid::shredFile(snapshotFilePath)) {
+                qDebug().noquote() << QString("Unable to open file %1 in Read/Write mode").arg(snapshotFilePath);
             }
-        });
-        appItemLayout->addWidget(editButton);
-
-        // Run button
-        QPushButton* runButton = new QPushButton(tr(LQD_ICON_RUN), this);
-        runButton->setCursor(Qt::PointingHandCursor);
-        runButton->setProperty("class", "liquidAppsListButtonRun");
-        appItemLayout->addWidget(runButton);
-        connect(runButton, &QPushButton::clicked, [liquidAppName]() {
-            Liquid::runLiquidApp(liquidAppName);
-        });
+        }
+
+        // Refresh table
+        populateTable();
 
-        appListTable->setCellWidget(i, 1, appItemActionButtonsWidget);
+        // Remove the icon from the icon cache unless some other Liquid app uses it too
+        LiquidAppIconCache::removeIconUnlessInUse(liquidAppIcon);
     }
 }
 
+void MainWindow::editLiquidApp(const QString liquidAppName)
+{
+    LiquidAppConfigDialog LiquidAppConfigDialog(this, liquidAppName);
+    switch (LiquidAppConfigDialog.exec()) {
+        case QDialog::Accepted:
+            // The config file is already synced by now
+            populateTable();
+        break;
+    }
+}
+
+void MainWindow::populateTable(void)
+{
+    appsDirRefreshTimer->stop();
+
+    // The watcher stops watching the directory if it gets removed
+    const QString appsDirPath = Liquid::getAppsDir().absolutePath();
+    if (!appsDirWatcher->directories().contains(appsDirPath)) {
+        QDir().mkpath(appsDirPath);
+        appsDirWatcher->addPath(appsDirPath);
+    }
+
+    // Only config files that have changed since the last time get parsed
+    liquidAppIndex->refresh();
+
+    // Only rows that have changed get updated
+    appListModel->setEntries(liquidAppIndex->getEntries());
+    appListModel->setInstanceRecords(LiquidInstanceRegistry::getRecords());
+}
+
 void MainWindow::saveSettings(void)
 {
     settings->setValue(LQD_CFG_KEY_NAME_WIN_GEOM, QString(saveGeometry().toHex()));